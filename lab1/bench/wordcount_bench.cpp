@@ -0,0 +1,223 @@
+#include "count_engine.h"
+#include "parallel_count.h"
+#include "word_count.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Пропускная способность путей подсчёта WordCount на синтетических корпусах.
+// Размеры корпусов: 1 МБ, 16 МБ, 256 МБ, 4 ГБ; верхняя граница задаётся
+// переменной окружения WORDCOUNT_BENCH_MAX_MB (по умолчанию 256)
+
+namespace {
+
+const size_t kMegabyte = 1 << 20;
+const size_t kSizesMb[] = {1, 16, 256, 4096};
+
+enum class Corpus { Ascii, Cyrillic, LongLines, Newlines };
+
+const char* corpusName(Corpus corpus) {
+    switch (corpus) {
+        case Corpus::Ascii: return "ascii";
+        case Corpus::Cyrillic: return "cyrillic";
+        case Corpus::LongLines: return "longlines";
+        case Corpus::Newlines: return "newlines";
+    }
+    return "";
+}
+
+uint64_t nextRandom(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Слова длиной 1-10 символов через пробел, строки по ~10 слов
+// (для LongLines — по ~64 КБ)
+std::string generate(Corpus corpus, size_t size) {
+    std::string text;
+    text.reserve(size + 64);
+    if (corpus == Corpus::Newlines) {
+        text.assign(size, '\n');
+        return text;
+    }
+
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    size_t lineLength = 0;
+    size_t maxLine = corpus == Corpus::LongLines ? (64 << 10) : 60;
+
+    while (text.size() < size) {
+        size_t wordLength = 1 + nextRandom(rng) % 10;
+        for (size_t i = 0; i < wordLength; ++i) {
+            unsigned letter = static_cast<unsigned>(nextRandom(rng) % 32);
+            if (corpus == Corpus::Cyrillic) {
+                // U+0430–U+044F
+                uint32_t cp = 0x430 + letter;
+                text.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                text.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            } else {
+                text.push_back(static_cast<char>('a' + letter % 26));
+            }
+        }
+        lineLength += wordLength + 1;
+        if (lineLength >= maxLine) {
+            text.push_back('\n');
+            lineLength = 0;
+        } else {
+            text.push_back(' ');
+        }
+    }
+
+    // Обрезаем по границе символа
+    while (text.size() > size && (static_cast<unsigned char>(text[size]) & 0xC0) == 0x80) {
+        --size;
+    }
+    text.resize(size);
+    return text;
+}
+
+size_t maxCorpusSize() {
+    const char* env = std::getenv("WORDCOUNT_BENCH_MAX_MB");
+    size_t mb = env != nullptr ? std::strtoull(env, nullptr, 10) : 256;
+    return (mb == 0 ? 256 : mb) * kMegabyte;
+}
+
+// Корпус максимального размера строится один раз, меньшие — его префиксы
+const std::string& corpusText(Corpus corpus) {
+    static std::map<Corpus, std::string> cache;
+    auto it = cache.find(corpus);
+    if (it == cache.end()) {
+        it = cache.emplace(corpus, generate(corpus, maxCorpusSize())).first;
+    }
+    return it->second;
+}
+
+// Корпус, записанный во временный файл, для путей с чтением с диска
+const std::string& corpusFile(Corpus corpus, size_t size) {
+    static std::map<std::pair<Corpus, size_t>, std::string> files;
+    auto key = std::make_pair(corpus, size);
+    auto it = files.find(key);
+    if (it == files.end()) {
+        std::string path = std::string("wordcount_bench_") + corpusName(corpus) + "_"
+                           + std::to_string(size / kMegabyte) + "mb.txt";
+        std::ofstream out(path, std::ios::binary);
+        out.write(corpusText(corpus).data(), static_cast<std::streamsize>(size));
+        it = files.emplace(key, path).first;
+    }
+    return it->second;
+}
+
+void removeCorpusFiles() {
+    for (Corpus corpus : {Corpus::Ascii, Corpus::Cyrillic, Corpus::LongLines, Corpus::Newlines}) {
+        for (size_t mb : kSizesMb) {
+            std::string path = std::string("wordcount_bench_") + corpusName(corpus) + "_"
+                               + std::to_string(mb) + "mb.txt";
+            std::remove(path.c_str());
+        }
+    }
+}
+
+void reportCounts(benchmark::State& state, size_t size, const CountResult& result) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    state.counters["lines"] = static_cast<double>(result.lines);
+    state.counters["words"] = static_cast<double>(result.words);
+    state.counters["chars"] = static_cast<double>(result.chars);
+}
+
+void benchKernel(benchmark::State& state, Corpus corpus, size_t size, CountKernel kernel) {
+    const std::string& text = corpusText(corpus);
+    CountResult result;
+    for (auto _ : state) {
+        CountEngine engine(CharMode::AsciiLetters, kernel);
+        engine.feed(text.data(), size);
+        result = engine.result();
+        benchmark::DoNotOptimize(result);
+    }
+    reportCounts(state, size, result);
+}
+
+void benchCharMode(benchmark::State& state, Corpus corpus, size_t size, CharMode mode) {
+    const std::string& text = corpusText(corpus);
+    CountResult result;
+    for (auto _ : state) {
+        CountEngine engine(mode);
+        engine.feed(text.data(), size);
+        result = engine.result();
+        benchmark::DoNotOptimize(result);
+    }
+    reportCounts(state, size, result);
+}
+
+void benchParallel(benchmark::State& state, Corpus corpus, size_t size, unsigned jobs) {
+    const std::string& text = corpusText(corpus);
+    CountOptions options;
+    options.jobs = jobs;
+    CountResult result;
+    for (auto _ : state) {
+        result = countParallel(text.data(), size, options);
+        benchmark::DoNotOptimize(result);
+    }
+    reportCounts(state, size, result);
+}
+
+void benchFile(benchmark::State& state, Corpus corpus, size_t size) {
+    WordCounter counter(corpusFile(corpus, size));
+    CountResult result;
+    for (auto _ : state) {
+        result = counter.count();
+        benchmark::DoNotOptimize(result);
+    }
+    reportCounts(state, size, result);
+}
+
+void registerAll() {
+    size_t maxSize = maxCorpusSize();
+    unsigned hardware = std::thread::hardware_concurrency();
+
+    for (Corpus corpus : {Corpus::Ascii, Corpus::Cyrillic, Corpus::LongLines, Corpus::Newlines}) {
+        for (size_t mb : kSizesMb) {
+            size_t size = mb * kMegabyte;
+            if (size > maxSize) {
+                break;
+            }
+            std::string suffix = std::string("/") + corpusName(corpus) + "/" + std::to_string(mb) + "MB";
+
+            for (const CountKernelInfo& info : availableCountKernels()) {
+                benchmark::RegisterBenchmark(("kernel/" + std::string(info.name) + suffix).c_str(),
+                                             benchKernel, corpus, size, info.kernel);
+            }
+            benchmark::RegisterBenchmark(("utf8/codepoints" + suffix).c_str(),
+                                         benchCharMode, corpus, size, CharMode::CodePoints);
+            benchmark::RegisterBenchmark(("utf8/letters" + suffix).c_str(),
+                                         benchCharMode, corpus, size, CharMode::Letters);
+            if (hardware > 1) {
+                benchmark::RegisterBenchmark(("parallel/j" + std::to_string(hardware) + suffix).c_str(),
+                                             benchParallel, corpus, size, hardware)->UseRealTime();
+            }
+            benchmark::RegisterBenchmark(("file/mmap" + suffix).c_str(), benchFile, corpus, size);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    registerAll();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    removeCorpusFiles();
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include "count_cache.h"
+#include "file_source.h"
+#include "parallel_count.h"
+#include "word_count.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+
+// Отпечаток снимается с начала файла: при перезаписи файла на месте
+// оно почти наверняка изменится
+const size_t kFingerprintSize = 4096;
+const size_t kTailBufferSize = 256 << 10;
+
+// FNV-1a
+uint64_t fingerprintOf(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t fingerprintOf(std::ifstream& file, uint64_t size) {
+    std::vector<char> head(size < kFingerprintSize ? size : kFingerprintSize);
+    file.read(head.data(), head.size());
+    if (file.gcount() != static_cast<std::streamsize>(head.size())) {
+        return 0;
+    }
+    return fingerprintOf(head.data(), head.size());
+}
+
+} // namespace
+
+CountCache::CountCache(const std::string& path) : path(path) {
+    std::ifstream in(path);
+    std::string line;
+
+    // Формат строки: inode size mtime fingerprint <состояние счётчика>\t<путь>
+    while (std::getline(in, line)) {
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos) {
+            continue;
+        }
+        std::istringstream fields(line.substr(0, tab));
+        Entry entry;
+        fields >> entry.inode >> entry.size >> entry.mtime >> entry.fingerprint;
+        if (!fields) {
+            continue;
+        }
+        std::getline(fields >> std::ws, entry.engineState);
+        entries[line.substr(tab + 1)] = entry;
+    }
+}
+
+bool CountCache::save() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        for (const auto& item : entries) {
+            const Entry& entry = item.second;
+            out << entry.inode << ' ' << entry.size << ' ' << entry.mtime << ' '
+                << entry.fingerprint << ' ' << entry.engineState << '\t' << item.first << '\n';
+        }
+        if (!out) {
+            return false;
+        }
+    }
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool CountCache::lookup(const std::string& filename, Entry& entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(filename);
+    if (it == entries.end()) {
+        return false;
+    }
+    entry = it->second;
+    return true;
+}
+
+void CountCache::store(const std::string& filename, const Entry& entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[filename] = entry;
+}
+
+CountResult CountCache::count(const std::string& filename, const CountOptions& options) {
+    CountOptions uncached = options;
+    uncached.cache = nullptr;
+
+    struct stat st;
+    // Частоты слов и длины строк в контрольной точке не хранятся
+    bool cacheable = options.topWords == 0 && !options.lineStats
+                     && filename != "-" && filename.find('\n') == std::string::npos
+                     && stat(filename.c_str(), &st) == 0 && (st.st_mode & S_IFMT) == S_IFREG;
+    if (!cacheable) {
+        return WordCounter(filename).count(uncached);
+    }
+    uint64_t bytesRead = 0;
+
+    Entry current;
+    current.inode = static_cast<uint64_t>(st.st_ino);
+    current.size = static_cast<uint64_t>(st.st_size);
+    current.mtime = static_cast<int64_t>(st.st_mtime);
+
+    Entry saved;
+    bool known = lookup(filename, saved) && saved.inode == current.inode
+                 && saved.size <= current.size;
+
+    CountEngine engine(options);
+    if (known) {
+        std::istringstream state(saved.engineState);
+        known = engine.load(state);
+    }
+
+    if (known) {
+        // Размер и время не изменились — файл не трогали
+        if (saved.size == current.size && saved.mtime == current.mtime) {
+            return engine.result();
+        }
+        bytesRead = kFingerprintSize < saved.size ? kFingerprintSize : saved.size;
+
+        std::ifstream file(filename, std::ios::binary);
+        known = fingerprintOf(file, saved.size) == saved.fingerprint;
+
+        if (known) {
+            file.seekg(static_cast<std::streamoff>(saved.size));
+            std::vector<char> buffer(kTailBufferSize);
+            uint64_t left = current.size - saved.size;
+            while (left > 0 && file) {
+                size_t want = left < buffer.size() ? static_cast<size_t>(left) : buffer.size();
+                file.read(buffer.data(), want);
+                size_t got = static_cast<size_t>(file.gcount());
+                engine.feed(buffer.data(), got);
+                left -= got;
+                bytesRead += got;
+            }
+            if (file.bad()) {
+                return readErrorResult();
+            }
+            current.size -= left;
+        }
+    }
+
+    if (!known) {
+        FileSource source(filename);
+        engine = countChunks(source.data(), source.size(), uncached);
+        // Неполный подсчёт нельзя ни выводить, ни сохранять как точку
+        if (source.hasError()) {
+            return readErrorResult();
+        }
+        current.size = source.size();
+        bytesRead = current.size;
+    }
+
+    std::ifstream file(filename, std::ios::binary);
+    current.fingerprint = fingerprintOf(file, current.size);
+    if (file.bad()) {
+        return readErrorResult();
+    }
+
+    std::ostringstream state;
+    engine.save(state);
+    current.engineState = state.str();
+    store(filename, current);
+
+    CountResult result = engine.result();
+    result.stats.bytesRead = bytesRead;
+    return result;
+}
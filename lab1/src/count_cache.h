@@ -0,0 +1,45 @@
+#ifndef COUNT_CACHE_H
+#define COUNT_CACHE_H
+
+#include "count_engine.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Хранилище контрольных точек для файлов, которые только дописываются.
+// Для каждого пути запоминаются inode, размер, время изменения, отпечаток
+// начала файла и полное состояние счётчика на последнем прочитанном байте.
+// При следующем запуске читается только дописанный хвост. Если файл
+// укоротился, сменил inode (ротация) или его начало изменилось,
+// выполняется полный подсчёт
+class CountCache {
+private:
+    struct Entry {
+        uint64_t inode = 0;
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t fingerprint = 0;
+        std::string engineState;
+    };
+
+    std::string path;
+    std::map<std::string, Entry> entries;
+    std::mutex mutex;
+
+    bool lookup(const std::string& filename, Entry& entry);
+    void store(const std::string& filename, const Entry& entry);
+
+public:
+    // Загружает хранилище; отсутствующий файл означает пустое хранилище
+    explicit CountCache(const std::string& path);
+
+    // Записывает хранилище на диск (через временный файл и rename)
+    bool save();
+
+    // Подсчёт с использованием и обновлением контрольной точки
+    CountResult count(const std::string& filename, const CountOptions& options);
+};
+
+#endif // COUNT_CACHE_H
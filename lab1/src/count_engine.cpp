@@ -0,0 +1,163 @@
+#include "count_engine.h"
+
+#include <istream>
+#include <ostream>
+
+namespace {
+
+// Если кроме ядра есть другие проходы, данные обходятся порциями такого
+// размера, чтобы следующий проход читал их ещё из кэша
+const size_t kSliceSize = 128 << 10;
+
+} // namespace
+
+CountEngine::CountEngine(CharMode charMode, CountKernel kernel)
+    : kernel(kernel), charMode(charMode), utf8(charMode == CharMode::Letters) {}
+
+CountEngine::CountEngine(const CountOptions& options)
+    : CountEngine(options.charMode,
+                  options.lineStats ? bestCountKernel().lineKernel : bestCountKernel().kernel) {
+    topWords = options.topWords;
+    lineStats = options.lineStats;
+}
+
+void CountEngine::feed(const char* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    bool decodeUtf8 = charMode != CharMode::AsciiLetters;
+
+    if (!decodeUtf8 && topWords == 0) {
+        kernel(p, size, state);
+    } else {
+        for (size_t offset = 0; offset < size; offset += kSliceSize) {
+            size_t slice = size - offset < kSliceSize ? size - offset : kSliceSize;
+            kernel(p + offset, slice, state);
+            if (decodeUtf8) {
+                utf8.feed(p + offset, slice);
+            }
+            if (topWords > 0) {
+                frequency.feed(data + offset, slice);
+            }
+        }
+    }
+
+    if (bytes == 0) {
+        firstByte = p[0];
+    }
+    bytes += size;
+    lastByte = p[size - 1];
+}
+
+void CountEngine::merge(const CountEngine& next) {
+    if (next.bytes == 0) {
+        return;
+    }
+    if (bytes == 0) {
+        CountKernel own = kernel;
+        *this = next;
+        kernel = own;
+        return;
+    }
+
+    state.newlines += next.state.newlines;
+    state.words += next.state.words;
+    state.chars += next.state.chars;
+    state.inWord = next.state.inWord;
+    if (lineStats) {
+        mergeLines(next.state);
+    }
+    utf8.merge(next.utf8);
+    if (topWords > 0) {
+        frequency.merge(next.frequency);
+    }
+
+    // next начал считать с состояния "вне слова" и засчитал продолжение
+    // нашего последнего слова как новое слово
+    if (!isAsciiSpace(lastByte) && !isAsciiSpace(next.firstByte)) {
+        --state.words;
+    }
+
+    bytes += next.bytes;
+    lastByte = next.lastByte;
+}
+
+void CountEngine::mergeLines(const KernelState& next) {
+    LineStats& lines = state.lines;
+    if (next.lines.count == 0) {
+        // В next нет '\n': вся часть продолжает нашу последнюю строку
+        state.lineLength += next.lineLength;
+        return;
+    }
+
+    // Первая строка next на самом деле продолжение нашей незавершённой
+    uint64_t joined = state.lineLength + next.lines.first;
+    LineStats tail = next.lines;
+    --tail.histogram[LineStats::bucketOf(tail.first)];
+    --tail.count;
+
+    lines.add(joined);
+    lines.count += tail.count;
+    for (int i = 0; i < LineStats::kBuckets; ++i) {
+        lines.histogram[i] += tail.histogram[i];
+    }
+    if (tail.longest > lines.longest) {
+        lines.longest = tail.longest;
+    }
+    state.lineLength = next.lineLength;
+}
+
+CountResult CountEngine::result() const {
+    CountResult res;
+    // Последняя строка без завершающего '\n' тоже считается, как у std::getline
+    res.lines = state.newlines + (bytes > 0 && lastByte != '\n');
+    res.words = state.words;
+    res.bytes = bytes;
+    if (charMode == CharMode::AsciiLetters) {
+        res.chars = state.chars;
+    } else {
+        res.chars = charMode == CharMode::Letters ? utf8.letterCount() : utf8.codePoints();
+        res.invalidUtf8 = utf8.invalidCount();
+        res.invalidUtf8Offsets = utf8.invalidOffsets();
+    }
+    if (topWords > 0) {
+        res.topWords = frequency.top(topWords);
+    }
+    if (lineStats) {
+        LineStats lines = state.lines;
+        if (bytes > 0 && lastByte != '\n') {
+            lines.add(state.lineLength);
+        }
+        res.longestLine = lines.longest;
+        res.lineLengthSum = bytes - state.newlines;
+        int used = LineStats::kBuckets;
+        while (used > 0 && lines.histogram[used - 1] == 0) {
+            --used;
+        }
+        res.lineHistogram.assign(lines.histogram, lines.histogram + used);
+    }
+    return res;
+}
+
+void CountEngine::save(std::ostream& out) const {
+    out << static_cast<int>(charMode) << ' '
+        << state.newlines << ' ' << state.words << ' ' << state.chars << ' ' << state.inWord << ' '
+        << bytes << ' ' << static_cast<int>(firstByte) << ' ' << static_cast<int>(lastByte) << ' ';
+    utf8.save(out);
+}
+
+bool CountEngine::load(std::istream& in) {
+    int mode;
+    int first;
+    int last;
+    in >> mode >> state.newlines >> state.words >> state.chars >> state.inWord
+       >> bytes >> first >> last;
+    if (!in || mode != static_cast<int>(charMode)) {
+        return false;
+    }
+    firstByte = static_cast<unsigned char>(first);
+    lastByte = static_cast<unsigned char>(last);
+    return utf8.load(in);
+}
@@ -0,0 +1,148 @@
+#ifndef COUNT_ENGINE_H
+#define COUNT_ENGINE_H
+
+#include "count_kernels.h"
+#include "utf8_count.h"
+#include "word_freq.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Что считать символами
+enum class CharMode {
+    AsciiLetters, // латинские буквы, как std::isalpha в локали "C"
+    CodePoints,   // символы Unicode в UTF-8
+    Letters       // буквы Unicode в UTF-8 (латиница, греческий, кириллица)
+};
+
+class CountCache;
+
+// Параметры подсчёта, общие для всех источников
+struct CountOptions {
+    unsigned jobs = 1;
+    CharMode charMode = CharMode::AsciiLetters;
+    // Хранилище контрольных точек для дописываемых файлов (может отсутствовать)
+    CountCache* cache = nullptr;
+    // Читать наборы файлов через io_uring, если он доступен
+    bool uring = false;
+    // Сколько самых частых слов вернуть (0 — частоты не считаются)
+    size_t topWords = 0;
+    // Собирать длины строк (самая длинная, средняя, гистограмма)
+    bool lineStats = false;
+};
+
+// Замеры подсчёта одного файла (--stats). Для отображённых в память
+// файлов чтение с диска происходит при обращении к страницам, поэтому
+// в ioSeconds попадают только открытие и отображение
+struct CountStats {
+    uint64_t bytesRead = 0;
+    double wallSeconds = 0;
+    double cpuSeconds = 0;
+    double ioSeconds = 0;
+    double countSeconds = 0;
+};
+
+// Результат подсчёта всех метрик за один проход
+struct CountResult {
+    uint64_t lines = 0;
+    uint64_t words = 0;
+    uint64_t bytes = 0;
+    uint64_t chars = 0;
+
+    // Только для режимов UTF-8: число некорректных последовательностей
+    // и смещения первых из них
+    uint64_t invalidUtf8 = 0;
+    std::vector<uint64_t> invalidUtf8Offsets;
+
+    // Только при CountOptions::topWords > 0: самые частые слова
+    std::vector<std::pair<std::string, uint64_t>> topWords;
+
+    // Только при CountOptions::lineStats: длина самой длинной строки,
+    // сумма длин строк (для среднего) и гистограмма по корзинам
+    // LineStats (без пустых корзин в конце). Длины в байтах без '\n'
+    uint64_t longestLine = 0;
+    uint64_t lineLengthSum = 0;
+    std::vector<uint64_t> lineHistogram;
+
+    CountStats stats;
+
+    // Файл не дочитан из-за ошибки ввода-вывода или укоротился во время
+    // подсчёта. Счётчики тогда нулевые, и файл не выводится
+    bool readError = false;
+};
+
+// Результат файла, чтение которого оборвалось
+inline CountResult readErrorResult() {
+    CountResult result;
+    result.readError = true;
+    return result;
+}
+
+// Сложение результатов разных файлов (для итоговой строки)
+inline CountResult& operator+=(CountResult& total, const CountResult& other) {
+    total.lines += other.lines;
+    total.words += other.words;
+    total.bytes += other.bytes;
+    total.chars += other.chars;
+    total.invalidUtf8 += other.invalidUtf8;
+    if (other.longestLine > total.longestLine) {
+        total.longestLine = other.longestLine;
+    }
+    total.lineLengthSum += other.lineLengthSum;
+    if (other.lineHistogram.size() > total.lineHistogram.size()) {
+        total.lineHistogram.resize(other.lineHistogram.size());
+    }
+    for (size_t i = 0; i < other.lineHistogram.size(); ++i) {
+        total.lineHistogram[i] += other.lineHistogram[i];
+    }
+    total.stats.bytesRead += other.stats.bytesRead;
+    total.stats.wallSeconds += other.stats.wallSeconds;
+    total.stats.cpuSeconds += other.stats.cpuSeconds;
+    total.stats.ioSeconds += other.stats.ioSeconds;
+    total.stats.countSeconds += other.stats.countSeconds;
+    return total;
+}
+
+// Потоковый счётчик: данные подаются блоками, состояние слова
+// сохраняется между блоками, поэтому результат не зависит от их размера
+class CountEngine {
+private:
+    CountKernel kernel;
+    CharMode charMode;
+    KernelState state;
+    Utf8Counter utf8;
+    size_t topWords = 0;
+    WordFrequency frequency;
+    bool lineStats = false;
+    uint64_t bytes = 0;
+    unsigned char firstByte = '\n';
+    unsigned char lastByte = '\n';
+
+    void mergeLines(const KernelState& next);
+
+public:
+    explicit CountEngine(CharMode charMode = CharMode::AsciiLetters,
+                         CountKernel kernel = bestCountKernel().kernel);
+    explicit CountEngine(const CountOptions& options);
+
+    void feed(const char* data, size_t size);
+
+    // Присоединяет результат счётчика, обработавшего данные сразу после
+    // данных этого счётчика. Слово, разрезанное границей, считается один раз
+    void merge(const CountEngine& next);
+
+    CountResult result() const;
+
+    CharMode mode() const { return charMode; }
+
+    // Сохранение и восстановление состояния (контрольные точки CountCache).
+    // Ядро и частоты слов не сохраняются
+    void save(std::ostream& out) const;
+    bool load(std::istream& in);
+};
+
+#endif // COUNT_ENGINE_H
@@ -0,0 +1,251 @@
+#include "count_kernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define WORDCOUNT_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Латинская буква в смысле std::isalpha для локали "C"
+inline bool isLetter(unsigned char c) {
+    return static_cast<unsigned char>((c | 0x20) - 'a') < 26;
+}
+
+template <bool TrackLines>
+void scalarKernel(const unsigned char* data, size_t size, KernelState& state) {
+    uint64_t newlines = 0;
+    uint64_t words = 0;
+    uint64_t chars = 0;
+    bool inWord = state.inWord;
+
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char c = data[i];
+        bool space = isAsciiSpace(c);
+
+        newlines += (c == '\n');
+        if (TrackLines) {
+            if (c == '\n') {
+                state.lines.add(state.lineLength);
+                state.lineLength = 0;
+            } else {
+                ++state.lineLength;
+            }
+        }
+        words += (!space && !inWord);
+        chars += isLetter(c);
+        inWord = !space;
+    }
+
+    state.newlines += newlines;
+    state.words += words;
+    state.chars += chars;
+    state.inWord = inWord;
+}
+
+#ifdef WORDCOUNT_X86_KERNELS
+
+// Маски одного 64-байтного блока: бит i соответствует байту i
+struct BlockMasks {
+    uint64_t newline;
+    uint64_t space;
+    uint64_t letter;
+};
+
+// Длины строк по маске переводов строк блока: обходятся только
+// установленные биты, строка без '\n' переходит в следующий блок
+inline void trackLines(uint64_t newlines, KernelState& state) {
+    unsigned start = 0;
+    while (newlines != 0) {
+        unsigned pos = static_cast<unsigned>(__builtin_ctzll(newlines));
+        state.lines.add(state.lineLength + pos - start);
+        state.lineLength = 0;
+        start = pos + 1;
+        newlines &= newlines - 1;
+    }
+    state.lineLength += 64 - start;
+}
+
+// Начало слова — непробельный байт, перед которым пробельный.
+// prevSpace переносит последний бит предыдущего блока
+template <bool TrackLines>
+inline void accumulate(const BlockMasks& m, uint64_t& prevSpace, KernelState& state) {
+    uint64_t starts = ~m.space & ((m.space << 1) | prevSpace);
+    prevSpace = m.space >> 63;
+
+    state.newlines += __builtin_popcountll(m.newline);
+    state.words += __builtin_popcountll(starts);
+    state.chars += __builtin_popcountll(m.letter);
+    if (TrackLines) {
+        trackLines(m.newline, state);
+    }
+}
+
+// Хвост меньше блока досчитывается скалярно
+template <bool TrackLines>
+inline void finishTail(const unsigned char* data, size_t size, size_t done,
+                       uint64_t prevSpace, KernelState& state) {
+    state.inWord = (prevSpace == 0);
+    scalarKernel<TrackLines>(data + done, size - done, state);
+}
+
+__attribute__((target("sse2")))
+inline __m128i lessEqualU8(__m128i x, __m128i limit) {
+    return _mm_cmpeq_epi8(_mm_min_epu8(x, limit), x);
+}
+
+__attribute__((target("sse2")))
+inline void classify16(__m128i v, uint32_t& nl, uint32_t& sp, uint32_t& lt) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i blank = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i ctrlRange = _mm_set1_epi8('\r' - '\t');
+    const __m128i lowerBit = _mm_set1_epi8(0x20);
+    const __m128i letterA = _mm_set1_epi8('a');
+    const __m128i letterRange = _mm_set1_epi8(25);
+
+    __m128i isNl = _mm_cmpeq_epi8(v, newline);
+    __m128i isSp = _mm_or_si128(_mm_cmpeq_epi8(v, blank),
+                                lessEqualU8(_mm_sub_epi8(v, tab), ctrlRange));
+    __m128i folded = _mm_sub_epi8(_mm_or_si128(v, lowerBit), letterA);
+    __m128i isLt = lessEqualU8(folded, letterRange);
+
+    nl = static_cast<uint32_t>(_mm_movemask_epi8(isNl));
+    sp = static_cast<uint32_t>(_mm_movemask_epi8(isSp));
+    lt = static_cast<uint32_t>(_mm_movemask_epi8(isLt));
+}
+
+template <bool TrackLines>
+__attribute__((target("sse2")))
+void sse2Kernel(const unsigned char* data, size_t size, KernelState& state) {
+    uint64_t prevSpace = state.inWord ? 0 : 1;
+    size_t i = 0;
+
+    for (; i + 64 <= size; i += 64) {
+        BlockMasks m = {0, 0, 0};
+        for (int part = 0; part < 4; ++part) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + part * 16));
+            uint32_t nl;
+            uint32_t sp;
+            uint32_t lt;
+            classify16(v, nl, sp, lt);
+            m.newline |= static_cast<uint64_t>(nl) << (part * 16);
+            m.space |= static_cast<uint64_t>(sp) << (part * 16);
+            m.letter |= static_cast<uint64_t>(lt) << (part * 16);
+        }
+        accumulate<TrackLines>(m, prevSpace, state);
+    }
+
+    finishTail<TrackLines>(data, size, i, prevSpace, state);
+}
+
+__attribute__((target("avx2")))
+inline __m256i lessEqualU8(__m256i x, __m256i limit) {
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(x, limit), x);
+}
+
+__attribute__((target("avx2")))
+inline void classify32(__m256i v, uint32_t& nl, uint32_t& sp, uint32_t& lt) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i blank = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i ctrlRange = _mm256_set1_epi8('\r' - '\t');
+    const __m256i lowerBit = _mm256_set1_epi8(0x20);
+    const __m256i letterA = _mm256_set1_epi8('a');
+    const __m256i letterRange = _mm256_set1_epi8(25);
+
+    __m256i isNl = _mm256_cmpeq_epi8(v, newline);
+    __m256i isSp = _mm256_or_si256(_mm256_cmpeq_epi8(v, blank),
+                                   lessEqualU8(_mm256_sub_epi8(v, tab), ctrlRange));
+    __m256i folded = _mm256_sub_epi8(_mm256_or_si256(v, lowerBit), letterA);
+    __m256i isLt = lessEqualU8(folded, letterRange);
+
+    nl = static_cast<uint32_t>(_mm256_movemask_epi8(isNl));
+    sp = static_cast<uint32_t>(_mm256_movemask_epi8(isSp));
+    lt = static_cast<uint32_t>(_mm256_movemask_epi8(isLt));
+}
+
+template <bool TrackLines>
+__attribute__((target("avx2,popcnt")))
+void avx2Kernel(const unsigned char* data, size_t size, KernelState& state) {
+    uint64_t prevSpace = state.inWord ? 0 : 1;
+    size_t i = 0;
+
+    for (; i + 64 <= size; i += 64) {
+        uint32_t nlLo;
+        uint32_t spLo;
+        uint32_t ltLo;
+        uint32_t nlHi;
+        uint32_t spHi;
+        uint32_t ltHi;
+        classify32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), nlLo, spLo, ltLo);
+        classify32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32)), nlHi, spHi, ltHi);
+
+        BlockMasks m;
+        m.newline = nlLo | (static_cast<uint64_t>(nlHi) << 32);
+        m.space = spLo | (static_cast<uint64_t>(spHi) << 32);
+        m.letter = ltLo | (static_cast<uint64_t>(ltHi) << 32);
+        accumulate<TrackLines>(m, prevSpace, state);
+    }
+
+    finishTail<TrackLines>(data, size, i, prevSpace, state);
+}
+
+template <bool TrackLines>
+__attribute__((target("avx512f,avx512bw,popcnt")))
+void avx512Kernel(const unsigned char* data, size_t size, KernelState& state) {
+    const __m512i newline = _mm512_set1_epi8('\n');
+    const __m512i blank = _mm512_set1_epi8(' ');
+    const __m512i tab = _mm512_set1_epi8('\t');
+    const __m512i ctrlRange = _mm512_set1_epi8('\r' - '\t');
+    const __m512i lowerBit = _mm512_set1_epi8(0x20);
+    const __m512i letterA = _mm512_set1_epi8('a');
+    const __m512i letterRange = _mm512_set1_epi8(25);
+
+    uint64_t prevSpace = state.inWord ? 0 : 1;
+    size_t i = 0;
+
+    for (; i + 64 <= size; i += 64) {
+        __m512i v = _mm512_loadu_si512(data + i);
+
+        BlockMasks m;
+        m.newline = _mm512_cmpeq_epi8_mask(v, newline);
+        m.space = _mm512_cmpeq_epi8_mask(v, blank)
+                  | _mm512_cmple_epu8_mask(_mm512_sub_epi8(v, tab), ctrlRange);
+        m.letter = _mm512_cmple_epu8_mask(
+            _mm512_sub_epi8(_mm512_or_si512(v, lowerBit), letterA), letterRange);
+        accumulate<TrackLines>(m, prevSpace, state);
+    }
+
+    finishTail<TrackLines>(data, size, i, prevSpace, state);
+}
+
+#endif // WORDCOUNT_X86_KERNELS
+
+} // namespace
+
+std::vector<CountKernelInfo> availableCountKernels() {
+    std::vector<CountKernelInfo> kernels;
+    kernels.push_back({"scalar", scalarKernel<false>, scalarKernel<true>});
+
+#ifdef WORDCOUNT_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        kernels.push_back({"sse2", sse2Kernel<false>, sse2Kernel<true>});
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        kernels.push_back({"avx2", avx2Kernel<false>, avx2Kernel<true>});
+    }
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+        && __builtin_cpu_supports("popcnt")) {
+        kernels.push_back({"avx512", avx512Kernel<false>, avx512Kernel<true>});
+    }
+#endif
+
+    return kernels;
+}
+
+const CountKernelInfo& bestCountKernel() {
+    static const CountKernelInfo best = availableCountKernels().back();
+    return best;
+}
@@ -0,0 +1,73 @@
+#ifndef COUNT_KERNELS_H
+#define COUNT_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Распределение длин строк в байтах без '\n' (для -L и --line-hist).
+// Корзина 0 — пустые строки, корзина i — длины от 2^(i-1) до 2^i - 1
+struct LineStats {
+    static const int kBuckets = 65;
+
+    uint64_t count = 0;
+    uint64_t longest = 0;
+    // Длина первой строки: при слиянии частей она дописывается
+    // к незавершённой строке предыдущей части
+    uint64_t first = 0;
+    uint64_t histogram[kBuckets] = {};
+
+    static int bucketOf(uint64_t length) {
+        return length == 0 ? 0 : 64 - __builtin_clzll(length);
+    }
+
+    void add(uint64_t length) {
+        if (count == 0) {
+            first = length;
+        }
+        ++count;
+        ++histogram[bucketOf(length)];
+        if (length > longest) {
+            longest = length;
+        }
+    }
+};
+
+// Накопленные счётчики ядра. inWord — находимся ли внутри слова на конце
+// уже обработанных данных, нужен для слов, разрезанных границей блока
+struct KernelState {
+    uint64_t newlines = 0;
+    uint64_t words = 0;
+    uint64_t chars = 0;
+    bool inWord = false;
+
+    // Только у ядер с подсчётом длин строк: длина незавершённой строки
+    // и завершённые строки
+    uint64_t lineLength = 0;
+    LineStats lines;
+};
+
+// Пробельные символы в смысле std::isspace для локали "C"
+inline bool isAsciiSpace(unsigned char c) {
+    return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+}
+
+// Ядро подсчёта: обрабатывает size байт и дополняет state
+using CountKernel = void (*)(const unsigned char* data, size_t size, KernelState& state);
+
+// kernel — обычное ядро, lineKernel — то же ядро, которое дополнительно
+// собирает длины строк по той же маске переводов строк
+struct CountKernelInfo {
+    const char* name;
+    CountKernel kernel;
+    CountKernel lineKernel;
+};
+
+// Все ядра, поддерживаемые текущим процессором, от простого к быстрому.
+// Первым всегда идёт скалярное ядро
+std::vector<CountKernelInfo> availableCountKernels();
+
+// Самое быстрое ядро для текущего процессора (выбирается один раз через cpuid)
+const CountKernelInfo& bestCountKernel();
+
+#endif // COUNT_KERNELS_H
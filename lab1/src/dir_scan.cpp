@@ -0,0 +1,325 @@
+#include "dir_scan.h"
+#include "word_count.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <filesystem>
+#endif
+
+namespace {
+
+const size_t kDirentBufferSize = 64 << 10;
+
+bool matchClass(const std::string& pattern, size_t& p, char c) {
+    // pattern[p] == '['
+    size_t i = p + 1;
+    bool negate = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+    if (negate) {
+        ++i;
+    }
+    bool matched = false;
+    bool first = true;
+    while (i < pattern.size() && (first || pattern[i] != ']')) {
+        first = false;
+        char low = pattern[i];
+        char high = low;
+        if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+            high = pattern[i + 2];
+            i += 2;
+        }
+        if (c >= low && c <= high) {
+            matched = true;
+        }
+        ++i;
+    }
+    if (i >= pattern.size()) {
+        // Незакрытая скобка — обычный символ
+        p += 1;
+        return c == '[';
+    }
+    p = i + 1;
+    return matched != negate;
+}
+
+bool matchesAny(const std::vector<std::string>& patterns, const std::string& name) {
+    for (const auto& pattern : patterns) {
+        if (matchGlob(pattern, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Очередь найденных файлов: обход кладёт, считающие потоки забирают
+class FileQueue {
+private:
+    std::deque<std::pair<size_t, std::string>> items;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool closed = false;
+
+public:
+    void push(size_t index, std::string path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        items.emplace_back(index, std::move(path));
+        available.notify_one();
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        available.notify_all();
+    }
+
+    bool pop(std::pair<size_t, std::string>& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [&]() { return !items.empty() || closed; });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        return true;
+    }
+};
+
+class Walker {
+private:
+    const ScanFilter& filter;
+    FileQueue& queue;
+    size_t found = 0;
+
+    void offerFile(const std::string& path, const std::string& name) {
+        if (!filter.include.empty() && !matchesAny(filter.include, name)) {
+            return;
+        }
+        if (matchesAny(filter.exclude, name)) {
+            return;
+        }
+        queue.push(found++, path);
+    }
+
+    static std::string join(const std::string& dir, const std::string& name) {
+        return !dir.empty() && dir.back() == '/' ? dir + name : dir + "/" + name;
+    }
+
+public:
+    Walker(const ScanFilter& filter, FileQueue& queue) : filter(filter), queue(queue) {}
+
+#ifdef __linux__
+    // getdents64 с большим буфером: тип записи приходит вместе с именем,
+    // stat нужен только для файловых систем, которые его не сообщают
+    void walk(const std::string& dir) {
+        int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+
+        std::vector<char> buffer(kDirentBufferSize);
+        std::vector<std::string> subdirs;
+        std::vector<std::string> files;
+
+        while (true) {
+            long got = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+            if (got <= 0) {
+                break;
+            }
+            for (long pos = 0; pos < got;) {
+                const dirent64* entry = reinterpret_cast<const dirent64*>(buffer.data() + pos);
+                pos += entry->d_reclen;
+
+                std::string name = entry->d_name;
+                if (name == "." || name == "..") {
+                    continue;
+                }
+                unsigned char type = entry->d_type;
+                if (type == DT_UNKNOWN) {
+                    struct stat st;
+                    if (fstatat(fd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                        continue;
+                    }
+                    type = S_ISDIR(st.st_mode) ? DT_DIR : (S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN);
+                }
+                if (type == DT_DIR) {
+                    subdirs.push_back(name);
+                } else if (type == DT_REG) {
+                    files.push_back(name);
+                }
+            }
+        }
+        close(fd);
+
+        visit(dir, files, subdirs);
+    }
+#else
+    void walk(const std::string& dir) {
+        std::vector<std::string> subdirs;
+        std::vector<std::string> files;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(dir, error)) {
+            if (entry.is_symlink(error)) {
+                continue;
+            }
+            std::string name = entry.path().filename().string();
+            if (entry.is_directory(error)) {
+                subdirs.push_back(name);
+            } else if (entry.is_regular_file(error)) {
+                files.push_back(name);
+            }
+        }
+
+        visit(dir, files, subdirs);
+    }
+#endif
+
+    // Порядок внутри каталога — по имени, чтобы вывод был воспроизводимым
+    void visit(const std::string& dir, std::vector<std::string>& files,
+               std::vector<std::string>& subdirs) {
+        std::sort(files.begin(), files.end());
+        std::sort(subdirs.begin(), subdirs.end());
+        for (const auto& name : files) {
+            offerFile(join(dir, name), name);
+        }
+        for (const auto& name : subdirs) {
+            if (!matchesAny(filter.exclude, name)) {
+                walk(join(dir, name));
+            }
+        }
+    }
+};
+
+} // namespace
+
+bool matchGlob(const std::string& pattern, const std::string& name) {
+    size_t p = 0;
+    size_t n = 0;
+    size_t starP = std::string::npos;
+    size_t starN = 0;
+
+    while (n < name.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starN = n;
+            continue;
+        }
+        if (p < pattern.size()) {
+            size_t next = p;
+            bool ok;
+            if (pattern[p] == '[') {
+                ok = matchClass(pattern, next, name[n]);
+            } else {
+                ok = pattern[p] == '?' || pattern[p] == name[n];
+                next = p + 1;
+            }
+            if (ok) {
+                p = next;
+                ++n;
+                continue;
+            }
+        }
+        // Откат к последней звёздочке
+        if (starP == std::string::npos) {
+            return false;
+        }
+        p = starP + 1;
+        n = ++starN;
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+std::vector<std::pair<std::string, CountResult>> scanDirectory(
+    const std::string& root, const ScanFilter& filter,
+    const CountOptions& options, const ScanFileCallback& onFile) {
+    // "dir/" и "dir" — один и тот же каталог
+    std::string base = root;
+    while (base.size() > 1 && base.back() == '/') {
+        base.pop_back();
+    }
+    size_t relative = base == "/" ? 1 : base.size() + 1;
+
+    FileQueue queue;
+
+    std::thread walker([&]() {
+        Walker(filter, queue).walk(base);
+        queue.close();
+    });
+
+    CountOptions single = options;
+    single.jobs = 1;
+
+    std::map<size_t, std::pair<std::string, CountResult>> done;
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    unsigned workersLeft = options.jobs > 0 ? options.jobs : 1;
+    unsigned workerCount = workersLeft;
+
+    auto work = [&]() {
+        std::pair<size_t, std::string> item;
+        while (queue.pop(item)) {
+            CountResult result = WordCounter(item.second).count(single);
+            std::lock_guard<std::mutex> lock(doneMutex);
+            done.emplace(item.first, std::make_pair(std::move(item.second), std::move(result)));
+            doneCv.notify_one();
+        }
+        std::lock_guard<std::mutex> lock(doneMutex);
+        --workersLeft;
+        doneCv.notify_one();
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back(work);
+    }
+
+    // Суммы по каталогам: файл добавляется к каждому каталогу на пути от root
+    std::map<std::string, CountResult> directories;
+    directories[base] = CountResult();
+
+    size_t nextIndex = 0;
+    while (true) {
+        std::pair<std::string, CountResult> entry;
+        {
+            std::unique_lock<std::mutex> lock(doneMutex);
+            doneCv.wait(lock, [&]() {
+                return done.count(nextIndex) != 0 || (workersLeft == 0 && done.empty());
+            });
+            auto it = done.find(nextIndex);
+            if (it == done.end()) {
+                break;
+            }
+            entry = std::move(it->second);
+            done.erase(it);
+        }
+        ++nextIndex;
+
+        onFile(entry.first, entry.second);
+
+        directories[base] += entry.second;
+        for (size_t slash = entry.first.find('/', relative); slash != std::string::npos;
+             slash = entry.first.find('/', slash + 1)) {
+            directories[entry.first.substr(0, slash)] += entry.second;
+        }
+    }
+
+    walker.join();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    return std::vector<std::pair<std::string, CountResult>>(directories.begin(), directories.end());
+}
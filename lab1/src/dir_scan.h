@@ -0,0 +1,33 @@
+#ifndef DIR_SCAN_H
+#define DIR_SCAN_H
+
+#include "count_engine.h"
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Фильтр имён файлов для рекурсивного обхода. Шаблоны сравниваются
+// с именем файла без каталога; exclude также отсекает каталоги целиком
+struct ScanFilter {
+    std::vector<std::string> include;
+    std::vector<std::string> exclude;
+};
+
+// Шаблон в стиле shell: '*', '?', классы [abc], [a-z], [!a]
+bool matchGlob(const std::string& pattern, const std::string& name);
+
+using ScanFileCallback = std::function<void(const std::string& path, const CountResult& result)>;
+
+// Рекурсивно обходит root. Обход идёт в отдельном потоке и пополняет
+// очередь, которую разбирают options.jobs считающих потоков, так что
+// чтение каталогов совмещается с подсчётом. onFile вызывается в вызывающем
+// потоке в порядке обнаружения файлов. Возвращает суммы по каждому
+// каталогу (включая root), упорядоченные по пути. Символьные ссылки
+// не обходятся
+std::vector<std::pair<std::string, CountResult>> scanDirectory(
+    const std::string& root, const ScanFilter& filter,
+    const CountOptions& options, const ScanFileCallback& onFile);
+
+#endif // DIR_SCAN_H
@@ -0,0 +1,246 @@
+#include "estimate.h"
+#include "word_count.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const uint64_t kBlockSize = 64 << 10;
+// Начальная выборка и минимальное число блоков (8 МБ), при котором есть
+// смысл в выборке: меньшие файлы дешевле посчитать целиком
+const uint64_t kInitialBlocks = 128;
+const uint64_t kMinBlocks = kInitialBlocks;
+
+EstimateResult exactEstimate(const CountResult& result) {
+    EstimateResult estimate;
+    estimate.readError = result.readError;
+    estimate.lines.value = static_cast<double>(result.lines);
+    estimate.words.value = static_cast<double>(result.words);
+    estimate.chars.value = static_cast<double>(result.chars);
+    estimate.bytes = result.bytes;
+    estimate.sampledBytes = result.bytes;
+    estimate.exact = true;
+    return estimate;
+}
+
+EstimateResult countExactly(const std::string& filename, const CountOptions& options) {
+    CountOptions exact = options;
+    exact.topWords = 0;
+    exact.lineStats = false;
+    return exactEstimate(WordCounter(filename).count(exact));
+}
+
+#ifndef _WIN32
+
+// Вклад одного участка файла, не зависящий от соседних участков:
+// переводы строк, начала слов и символы внутри участка
+struct Contribution {
+    double newlines = 0;
+    double wordStarts = 0;
+    double chars = 0;
+};
+
+class Sampler {
+private:
+    int fd;
+    CountOptions options;
+    std::vector<char> buffer;
+
+public:
+    uint64_t bytesRead = 0;
+
+    Sampler(int fd, const CountOptions& options) : fd(fd), options(options), buffer(kBlockSize + 1) {}
+
+    // Читает участок вместе с предыдущим байтом: слово, начатое до участка,
+    // не должно считаться его началом
+    bool read(uint64_t offset, uint64_t size, Contribution& out) {
+        uint64_t from = offset > 0 ? offset - 1 : 0;
+        size_t want = static_cast<size_t>(offset - from + size);
+        size_t got = 0;
+        while (got < want) {
+            ssize_t n = pread(fd, buffer.data() + got, want - got, static_cast<off_t>(from + got));
+            if (n <= 0) {
+                return false;
+            }
+            got += static_cast<size_t>(n);
+        }
+        bytesRead += got;
+
+        const char* block = buffer.data() + (offset - from);
+        CountEngine engine(options.charMode);
+        engine.feed(block, static_cast<size_t>(size));
+        CountResult result = engine.result();
+
+        unsigned char last = static_cast<unsigned char>(block[size - 1]);
+        unsigned char first = static_cast<unsigned char>(block[0]);
+        bool continuesWord = offset > 0 && !isAsciiSpace(static_cast<unsigned char>(buffer[0]))
+                             && !isAsciiSpace(first);
+
+        out.newlines = static_cast<double>(result.lines - (last != '\n'));
+        out.wordStarts = static_cast<double>(result.words - continuesWord);
+        out.chars = static_cast<double>(result.chars);
+        return true;
+    }
+};
+
+// Оценка суммы по N блокам из выборки блоков, упорядоченной по смещению.
+// Блоки берутся по одному из полос, поэтому дисперсия оценивается по
+// разностям соседних блоков, как для систематической выборки: плавные
+// изменения состава по длине файла её почти не увеличивают, в отличие
+// от формулы для простой случайной выборки
+EstimatedValue extrapolate(const std::map<uint64_t, Contribution>& sample,
+                           double Contribution::*metric, uint64_t total) {
+    EstimatedValue result;
+    double count = static_cast<double>(sample.size());
+    double population = static_cast<double>(total);
+
+    double sum = 0;
+    double squaredSteps = 0;
+    const Contribution* previous = nullptr;
+    for (const auto& item : sample) {
+        double x = item.second.*metric;
+        sum += x;
+        if (previous != nullptr) {
+            double step = x - previous->*metric;
+            squaredSteps += step * step;
+        }
+        previous = &item.second;
+    }
+
+    result.value = sum / count * population;
+    if (sample.size() > 1 && sample.size() < total) {
+        double variance = squaredSteps / (2 * (count - 1));
+        result.stdError = population * std::sqrt(variance / count * (1 - count / population));
+    }
+    return result;
+}
+
+double relativeError(const EstimatedValue& v) {
+    return v.value > 0 ? kConfidenceZ * v.stdError / v.value : 0;
+}
+
+#endif // _WIN32
+
+} // namespace
+
+EstimateResult& operator+=(EstimateResult& total, const EstimateResult& other) {
+    for (auto member : {&EstimateResult::lines, &EstimateResult::words, &EstimateResult::chars}) {
+        EstimatedValue& sum = total.*member;
+        const EstimatedValue& add = other.*member;
+        sum.value += add.value;
+        sum.stdError = std::sqrt(sum.stdError * sum.stdError + add.stdError * add.stdError);
+    }
+    total.bytes += other.bytes;
+    total.sampledBytes += other.sampledBytes;
+    total.blocks += other.blocks;
+    total.exact = total.exact && other.exact;
+    return total;
+}
+
+#ifdef _WIN32
+
+EstimateResult estimateFile(const std::string& filename, const CountOptions& options, double) {
+    return countExactly(filename, options);
+}
+
+#else
+
+EstimateResult estimateFile(const std::string& filename, const CountOptions& options, double targetError) {
+    int fd = filename == "-" ? -1 : open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || (st.st_mode & S_IFMT) != S_IFREG
+        || static_cast<uint64_t>(st.st_size) / kBlockSize < kMinBlocks) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return countExactly(filename, options);
+    }
+
+#ifdef POSIX_FADV_RANDOM
+    posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
+#endif
+
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+    uint64_t totalBlocks = size / kBlockSize;
+    uint64_t tailSize = size - totalBlocks * kBlockSize;
+    Sampler sampler(fd, options);
+
+    // Неполный хвост считается точно. Даже без хвоста нужен последний байт:
+    // строка без завершающего '\n' тоже считается
+    // Если они не прочитались (файл укоротили или ошибка диска), оценка
+    // неполна: файл считается целиком, как при ошибке чтения блока
+    Contribution tail;
+    unsigned char lastByte = '\n';
+    if ((tailSize > 0 && !sampler.read(totalBlocks * kBlockSize, tailSize, tail))
+        || pread(fd, &lastByte, 1, static_cast<off_t>(size - 1)) != 1) {
+        close(fd);
+        return countExactly(filename, options);
+    }
+
+    std::map<uint64_t, Contribution> taken;
+    std::mt19937_64 rng(std::random_device{}());
+
+    uint64_t wanted = kInitialBlocks;
+    EstimateResult estimate;
+    while (true) {
+        // Новые блоки берутся по одному из равных полос файла: выборка
+        // покрывает весь файл, и участки с другим составом не пропускаются
+        uint64_t strata = wanted - taken.size();
+        for (uint64_t s = 0; s < strata; ++s) {
+            uint64_t begin = totalBlocks * s / strata;
+            uint64_t end = totalBlocks * (s + 1) / strata;
+            std::uniform_int_distribution<uint64_t> pick(begin, end - 1);
+            uint64_t block = pick(rng);
+            for (uint64_t tries = 0; taken.count(block) != 0 && tries < end - begin; ++tries) {
+                block = block + 1 < end ? block + 1 : begin;
+            }
+            if (taken.count(block) != 0) {
+                continue;
+            }
+            if (!sampler.read(block * kBlockSize, kBlockSize, taken[block])) {
+                close(fd);
+                return countExactly(filename, options);
+            }
+        }
+
+        uint64_t n = taken.size();
+        estimate.lines = extrapolate(taken, &Contribution::newlines, totalBlocks);
+        estimate.words = extrapolate(taken, &Contribution::wordStarts, totalBlocks);
+        estimate.chars = extrapolate(taken, &Contribution::chars, totalBlocks);
+
+        double worst = std::max({relativeError(estimate.lines), relativeError(estimate.words),
+                                 relativeError(estimate.chars)});
+        if (worst <= targetError || n == totalBlocks || strata == 0) {
+            break;
+        }
+
+        // Погрешность убывает как 1/sqrt(n): берём столько блоков, сколько
+        // нужно по текущей оценке дисперсии, но не меньше чем вдвое больше
+        double ratio = worst / targetError;
+        double needed = static_cast<double>(n) * ratio * ratio * 1.1;
+        wanted = needed > static_cast<double>(totalBlocks) ? totalBlocks : static_cast<uint64_t>(needed);
+        wanted = std::max(wanted, std::min(2 * n, totalBlocks));
+    }
+    close(fd);
+
+    estimate.lines.value += tail.newlines + (lastByte != '\n');
+    estimate.words.value += tail.wordStarts;
+    estimate.chars.value += tail.chars;
+    estimate.bytes = size;
+    estimate.sampledBytes = sampler.bytesRead;
+    estimate.blocks = taken.size();
+    estimate.exact = taken.size() == totalBlocks;
+    return estimate;
+}
+
+#endif // _WIN32
@@ -0,0 +1,42 @@
+#ifndef ESTIMATE_H
+#define ESTIMATE_H
+
+#include "count_engine.h"
+
+#include <cstdint>
+#include <string>
+
+// Оценка с погрешностью: value ± kConfidenceZ * stdError
+struct EstimatedValue {
+    double value = 0;
+    double stdError = 0;
+};
+
+// Доверительный интервал 95%
+const double kConfidenceZ = 1.96;
+
+struct EstimateResult {
+    EstimatedValue lines;
+    EstimatedValue words;
+    EstimatedValue chars;
+    uint64_t bytes = 0;
+    // Сколько байт и блоков прочитано; exact — файл посчитан целиком
+    uint64_t sampledBytes = 0;
+    uint64_t blocks = 0;
+    bool exact = false;
+    // Файл не удалось прочитать даже целиком (см. CountResult::readError)
+    bool readError = false;
+};
+
+// Сумма оценок независимых файлов: погрешности складываются квадратично
+EstimateResult& operator+=(EstimateResult& total, const EstimateResult& other);
+
+// Приблизительный подсчёт (--estimate). Файл делится на выровненные блоки
+// по 64 КБ, случайные блоки читаются через pread, и число строк, слов
+// и символов экстраполируется на весь файл. Выборка увеличивается, пока
+// полуширина 95% интервала для каждой ненулевой метрики не станет меньше
+// targetError от её оценки. Неполный последний блок считается точно.
+// Файлы меньше 8 МБ, потоки и стандартный ввод считаются целиком
+EstimateResult estimateFile(const std::string& filename, const CountOptions& options, double targetError);
+
+#endif // ESTIMATE_H
@@ -0,0 +1,74 @@
+#include "file_batch.h"
+#include "uring_reader.h"
+#include "word_count.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+void countFiles(const std::vector<std::string>& filenames, const CountOptions& options,
+                const FileResultCallback& onResult) {
+    // Один файл выгоднее делить на части, чем держать пул
+    if (filenames.size() == 1) {
+        onResult(0, WordCounter(filenames[0]).count(options));
+        return;
+    }
+
+    if (options.uring && countFilesUring(filenames, options, onResult)) {
+        return;
+    }
+
+    // Внутри пула каждый файл считается одним потоком
+    CountOptions single = options;
+    single.jobs = 1;
+
+    if (options.jobs <= 1) {
+        for (size_t i = 0; i < filenames.size(); ++i) {
+            onResult(i, WordCounter(filenames[i]).count(single));
+        }
+        return;
+    }
+
+    std::vector<CountResult> results(filenames.size());
+    std::vector<char> ready(filenames.size(), 0);
+    std::atomic<size_t> nextIndex(0);
+    std::mutex mutex;
+    std::condition_variable readyCv;
+
+    auto worker = [&]() {
+        while (true) {
+            size_t index = nextIndex.fetch_add(1);
+            if (index >= filenames.size()) {
+                return;
+            }
+            CountResult result = WordCounter(filenames[index]).count(single);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            results[index] = result;
+            ready[index] = 1;
+            readyCv.notify_one();
+        }
+    };
+
+    size_t threadCount = options.jobs < filenames.size() ? options.jobs : filenames.size();
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    for (size_t i = 0; i < filenames.size(); ++i) {
+        CountResult result;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            readyCv.wait(lock, [&]() { return ready[i] != 0; });
+            result = results[i];
+        }
+        onResult(i, result);
+    }
+
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef FILE_BATCH_H
+#define FILE_BATCH_H
+
+#include "count_engine.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+using FileResultCallback = std::function<void(size_t index, const CountResult& result)>;
+
+// Считает файлы пулом из options.jobs потоков. Одновременно открыто
+// не больше options.jobs файлов. onResult вызывается в вызывающем потоке
+// строго в порядке filenames, как только готовы все предыдущие файлы
+void countFiles(const std::vector<std::string>& filenames, const CountOptions& options,
+                const FileResultCallback& onResult);
+
+#endif // FILE_BATCH_H
@@ -0,0 +1,257 @@
+#include "file_source.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <csignal>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const size_t kReadChunk = 1 << 20;
+
+#ifdef _WIN32
+int openReadOnly(const std::string& filename) {
+    return _open(filename.c_str(), _O_RDONLY | _O_BINARY);
+}
+
+int stdinFd() {
+    _setmode(0, _O_BINARY);
+    return 0;
+}
+
+long readSome(int fd, char* dst, size_t size) {
+    return _read(fd, dst, static_cast<unsigned>(size));
+}
+
+void closeFd(int fd) {
+    _close(fd);
+}
+#else
+int openReadOnly(const std::string& filename) {
+    return open(filename.c_str(), O_RDONLY);
+}
+
+int stdinFd() {
+    return STDIN_FILENO;
+}
+
+long readSome(int fd, char* dst, size_t size) {
+    long got;
+    do {
+        got = ::read(fd, dst, size);
+    } while (got < 0 && errno == EINTR);
+    return got;
+}
+
+void closeFd(int fd) {
+    close(fd);
+}
+
+// Если отображённый файл укоротили, обращение к странице за новым концом
+// файла даёт SIGBUS. Обработчик находит отображение по адресу, заменяет
+// его хвост нулевыми страницами и помечает как усечённое: подсчёт
+// доходит до конца, а FileSource сообщает об ошибке вместо результата.
+// Таблица фиксированного размера, без блокировок: обработчик сигнала
+// читает её из любого потока
+const int kMaxGuardedMaps = 256;
+
+struct GuardedMap {
+    std::atomic<bool> used{false};
+    std::atomic<const char*> begin{nullptr};
+    std::atomic<size_t> length{0};
+    std::atomic<bool> truncated{false};
+};
+
+GuardedMap guardedMaps[kMaxGuardedMaps];
+uintptr_t pageSize = 4096;
+
+void onBusError(int sig, siginfo_t* info, void*) {
+    const char* addr = static_cast<const char*>(info->si_addr);
+    for (GuardedMap& map : guardedMaps) {
+        const char* begin = map.begin.load(std::memory_order_acquire);
+        if (begin == nullptr || addr < begin || addr >= begin + map.length.load()) {
+            continue;
+        }
+        uintptr_t page = reinterpret_cast<uintptr_t>(addr) & ~(pageSize - 1);
+        size_t rest = reinterpret_cast<uintptr_t>(begin) + map.length.load() - page;
+        void* zeros = mmap(reinterpret_cast<void*>(page), rest, PROT_READ,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+        if (zeros != MAP_FAILED) {
+            map.truncated.store(true);
+            return;
+        }
+        break;
+    }
+    // Чужая ошибка: стандартная реакция на повторном обращении
+    signal(sig, SIG_DFL);
+}
+
+// Возвращает номер записи таблицы или -1, если она заполнена
+int guardMap(const char* begin, size_t length) {
+    static std::once_flag installed;
+    std::call_once(installed, []() {
+        pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        struct sigaction action = {};
+        action.sa_sigaction = onBusError;
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGBUS, &action, nullptr);
+    });
+
+    for (int i = 0; i < kMaxGuardedMaps; ++i) {
+        bool expected = false;
+        if (guardedMaps[i].used.compare_exchange_strong(expected, true)) {
+            guardedMaps[i].length.store(length);
+            guardedMaps[i].truncated.store(false);
+            guardedMaps[i].begin.store(begin, std::memory_order_release);
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Снимает защиту; возвращает true, если файл укоротился
+bool releaseMap(int slot) {
+    GuardedMap& map = guardedMaps[slot];
+    map.begin.store(nullptr, std::memory_order_release);
+    bool truncated = map.truncated.load();
+    map.used.store(false);
+    return truncated;
+}
+#endif
+
+} // namespace
+
+FileSource::FileSource(const std::string& filename) {
+    if (filename == "-") {
+        fd = stdinFd();
+        ownsFd = false;
+    } else {
+        fd = openReadOnly(filename);
+    }
+    load();
+}
+
+FileSource::FileSource(int openFd) : fd(openFd), ownsFd(false) {
+    load();
+}
+
+void FileSource::load() {
+    if (fd < 0) {
+        return;
+    }
+    opened = true;
+
+    struct stat st;
+    bool regular = fstat(fd, &st) == 0 && (st.st_mode & S_IFMT) == S_IFREG;
+
+    if (!regular) {
+        stream = true;
+        return;
+    }
+    if (!tryMap(static_cast<size_t>(st.st_size))) {
+        readAll();
+    }
+
+    if (ownsFd) {
+        closeFd(fd);
+    }
+    fd = -1;
+}
+
+FileSource::~FileSource() {
+#ifndef _WIN32
+    if (mapped) {
+        if (guardSlot >= 0) {
+            releaseMap(guardSlot);
+        }
+        munmap(const_cast<char*>(begin), length);
+    }
+#endif
+    if (fd >= 0 && ownsFd) {
+        closeFd(fd);
+    }
+}
+
+bool FileSource::hasError() const {
+#ifndef _WIN32
+    if (guardSlot >= 0 && guardedMaps[guardSlot].truncated.load()) {
+        return true;
+    }
+#endif
+    return failed;
+}
+
+size_t FileSource::read(char* dst, size_t size) {
+    if (fd < 0) {
+        return 0;
+    }
+    long got = readSome(fd, dst, size);
+    if (got < 0) {
+        failed = true;
+        return 0;
+    }
+    return static_cast<size_t>(got);
+}
+
+bool FileSource::tryMap(size_t fileSize) {
+#ifdef _WIN32
+    (void)fileSize;
+    return false;
+#else
+    if (fileSize == 0) {
+        // Пустой файл отобразить нельзя, но и читать в нём нечего.
+        // Файлы из /proc тоже имеют нулевой размер, поэтому всё же читаем.
+        return false;
+    }
+
+    void* addr = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    // Без защиты от усечения отображение опасно: читаем в буфер
+    guardSlot = guardMap(static_cast<const char*>(addr), fileSize);
+    if (guardSlot < 0) {
+        munmap(addr, fileSize);
+        return false;
+    }
+    madvise(addr, fileSize, MADV_SEQUENTIAL);
+
+    begin = static_cast<const char*>(addr);
+    length = fileSize;
+    mapped = true;
+    return true;
+#endif
+}
+
+void FileSource::readAll() {
+    size_t used = 0;
+    while (true) {
+        if (buffer.size() - used < kReadChunk) {
+            buffer.resize(used + kReadChunk);
+        }
+        size_t got = read(buffer.data() + used, buffer.size() - used);
+        if (got == 0) {
+            break;
+        }
+        used += got;
+    }
+    // После ошибки чтения частичные данные не отдаются
+    if (failed) {
+        used = 0;
+    }
+    buffer.resize(used);
+
+    begin = buffer.data();
+    length = used;
+}
@@ -0,0 +1,57 @@
+#ifndef FILE_SOURCE_H
+#define FILE_SOURCE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Источник данных для подсчёта.
+// Обычные файлы отдаются одним непрерывным диапазоном байт: через mmap
+// (без копирования) или, если отображение невозможно, через чтение в буфер.
+// Каналы, FIFO и стандартный ввод ("-") не буферизуются целиком: их нужно
+// вычитывать порциями через read(), чтобы память не зависела от объёма данных
+class FileSource {
+private:
+    const char* begin = nullptr;
+    size_t length = 0;
+    int fd = -1;
+    bool opened = false;
+    bool mapped = false;
+    bool stream = false;
+    bool ownsFd = true;
+    bool failed = false;
+    int guardSlot = -1; // Запись защиты отображения от усечения файла
+    std::vector<char> buffer;
+
+    void load();
+    bool tryMap(size_t fileSize);
+    void readAll();
+
+public:
+    explicit FileSource(const std::string& filename);
+    // Уже открытый файл: дескриптор не закрывается, содержимое читается
+    // с текущей позиции, если отобразить файл нельзя
+    explicit FileSource(int openFd);
+    ~FileSource();
+
+    FileSource(const FileSource&) = delete;
+    FileSource& operator=(const FileSource&) = delete;
+
+    bool isOpen() const { return opened; }
+    bool isMapped() const { return mapped; }
+    bool isStream() const { return stream; }
+
+    // Чтение оборвалось ошибкой или отображённый файл укоротился во время
+    // подсчёта: данные неполны, и результат по ним выводить нельзя.
+    // Для отображения проверять после обхода данных
+    bool hasError() const;
+
+    // Диапазон байт обычного файла (для потоков пуст)
+    const char* data() const { return begin; }
+    size_t size() const { return length; }
+
+    // Очередная порция потока; 0 — конец данных или ошибка (см. hasError)
+    size_t read(char* dst, size_t size);
+};
+
+#endif // FILE_SOURCE_H
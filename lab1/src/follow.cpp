@@ -0,0 +1,338 @@
+#include "follow.h"
+
+#ifdef __linux__
+
+#include "file_source.h"
+#include "parallel_count.h"
+#include "stopwatch.h"
+
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <limits>
+#include <map>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t kReadSize = 256 << 10;
+const size_t kEventBufferSize = 64 << 10;
+const int kMaxPollMs = std::numeric_limits<int>::max() - 1;
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) {
+    stopRequested = 1;
+}
+
+// SIGINT и SIGTERM без SA_RESTART: poll прерывается, и цикл завершается
+class StopSignals {
+private:
+    struct sigaction oldInt;
+    struct sigaction oldTerm;
+
+public:
+    StopSignals() {
+        stopRequested = 0;
+        struct sigaction action = {};
+        action.sa_handler = requestStop;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGINT, &action, &oldInt);
+        sigaction(SIGTERM, &action, &oldTerm);
+    }
+
+    ~StopSignals() {
+        sigaction(SIGINT, &oldInt, nullptr);
+        sigaction(SIGTERM, &oldTerm, nullptr);
+    }
+};
+
+std::string parentOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    if (slash == std::string::npos) {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+std::string baseOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+struct Followed {
+    std::string path;
+    std::string name;
+    int fd = -1;
+    int watch = -1;
+    uint64_t inode = 0;
+    uint64_t offset = 0;
+    CountEngine engine;
+    CountStats stats;
+    double started = 0;
+};
+
+class Follower {
+private:
+    const CountOptions& options;
+    int inotifyFd;
+    std::vector<Followed> files;
+    std::map<int, std::vector<size_t>> fileWatches;
+    std::map<int, std::vector<size_t>> dirWatches;
+    std::vector<char> buffer;
+
+    void unwatch(Followed& file) {
+        if (file.watch < 0) {
+            return;
+        }
+        std::vector<size_t>& owners = fileWatches[file.watch];
+        size_t index = static_cast<size_t>(&file - files.data());
+        for (size_t i = 0; i < owners.size(); ++i) {
+            if (owners[i] == index) {
+                owners.erase(owners.begin() + static_cast<std::ptrdiff_t>(i));
+                break;
+            }
+        }
+        if (owners.empty()) {
+            inotify_rm_watch(inotifyFd, file.watch);
+            fileWatches.erase(file.watch);
+        }
+        file.watch = -1;
+    }
+
+    // Новый файл под тем же именем: прежнее состояние отбрасывается
+    void reopen(Followed& file) {
+        unwatch(file);
+        if (file.fd >= 0) {
+            close(file.fd);
+        }
+        file.fd = open(file.path.c_str(), O_RDONLY | O_CLOEXEC);
+        file.inode = 0;
+        reset(file);
+        if (file.fd < 0) {
+            return;
+        }
+
+        struct stat st;
+        if (fstat(file.fd, &st) != 0) {
+            return;
+        }
+        file.inode = static_cast<uint64_t>(st.st_ino);
+        file.watch = inotify_add_watch(inotifyFd, file.path.c_str(),
+                                       IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF | IN_ATTRIB);
+        if (file.watch >= 0) {
+            fileWatches[file.watch].push_back(static_cast<size_t>(&file - files.data()));
+        }
+        countInitial(file);
+    }
+
+    void reset(Followed& file) {
+        file.offset = 0;
+        file.engine = CountEngine(options);
+        file.stats = CountStats();
+        file.started = wallSeconds();
+    }
+
+    // Уже записанная часть файла считается через FileSource (отображение
+    // защищено от усечения) и, при options.jobs > 1, в несколько потоков.
+    // Если файл укоротился или не прочитался, он дочитывается заново
+    // через pread в readAppended
+    void countInitial(Followed& file) {
+        FileSource source(file.fd);
+        if (source.isStream() || source.size() == 0) {
+            return;
+        }
+        double countStart = wallSeconds();
+        CountEngine engine = countChunks(source.data(), source.size(), options);
+        if (source.hasError()) {
+            return;
+        }
+        file.engine = engine;
+        file.stats.countSeconds += wallSeconds() - countStart;
+        file.offset = source.size();
+        file.stats.bytesRead = source.size();
+    }
+
+    // Дочитывает файл до текущего конца
+    void readAppended(Followed& file) {
+        while (file.fd >= 0) {
+            double readStart = wallSeconds();
+            ssize_t got = pread(file.fd, buffer.data(), buffer.size(), static_cast<off_t>(file.offset));
+            double readEnd = wallSeconds();
+            file.stats.ioSeconds += readEnd - readStart;
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got <= 0) {
+                return;
+            }
+            file.engine.feed(buffer.data(), static_cast<size_t>(got));
+            file.stats.countSeconds += wallSeconds() - readEnd;
+            file.offset += static_cast<uint64_t>(got);
+            file.stats.bytesRead += static_cast<uint64_t>(got);
+        }
+    }
+
+    // Проверяет, на что указывает имя, и дочитывает новые данные.
+    // Если имени нет (файл переименован, новый ещё не создан), дочитывается
+    // прежний файл: в него ещё может писать процесс, не заметивший ротации
+    void refresh(Followed& file) {
+        struct stat st;
+        if (stat(file.path.c_str(), &st) == 0 && static_cast<uint64_t>(st.st_ino) != file.inode) {
+            reopen(file);
+        } else if (file.fd >= 0 && fstat(file.fd, &st) == 0
+                   && static_cast<uint64_t>(st.st_size) < file.offset) {
+            // Усечение на месте (copytruncate)
+            reset(file);
+        }
+        readAppended(file);
+    }
+
+public:
+    Follower(const std::vector<std::string>& filenames, const CountOptions& options, int inotifyFd)
+        : options(options), inotifyFd(inotifyFd), buffer(kReadSize) {
+        files.resize(filenames.size());
+        for (size_t i = 0; i < filenames.size(); ++i) {
+            Followed& file = files[i];
+            file.path = filenames[i];
+            file.name = baseOf(filenames[i]);
+            file.engine = CountEngine(options);
+            file.started = wallSeconds();
+
+            int dirWatch = inotify_add_watch(inotifyFd, parentOf(file.path).c_str(),
+                                             IN_CREATE | IN_MOVED_TO | IN_ONLYDIR);
+            if (dirWatch >= 0) {
+                dirWatches[dirWatch].push_back(i);
+            }
+            reopen(file);
+            readAppended(file);
+        }
+    }
+
+    ~Follower() {
+        for (Followed& file : files) {
+            if (file.fd >= 0) {
+                close(file.fd);
+            }
+        }
+    }
+
+    // Разбирает накопившиеся события; true — какие-то файлы обновлены
+    bool handleEvents() {
+        std::vector<char> events(kEventBufferSize);
+        ssize_t got = read(inotifyFd, events.data(), events.size());
+        if (got <= 0) {
+            return false;
+        }
+
+        std::vector<char> touched(files.size(), 0);
+        for (ssize_t pos = 0; pos < got;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(events.data() + pos);
+            pos += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // События потеряны: проверяем все файлы
+                touched.assign(files.size(), 1);
+                continue;
+            }
+            auto fileIt = fileWatches.find(event->wd);
+            if (fileIt != fileWatches.end()) {
+                for (size_t index : fileIt->second) {
+                    touched[index] = 1;
+                }
+            }
+            auto dirIt = dirWatches.find(event->wd);
+            if (dirIt != dirWatches.end() && event->len > 0) {
+                for (size_t index : dirIt->second) {
+                    if (files[index].name == event->name) {
+                        touched[index] = 1;
+                    }
+                }
+            }
+        }
+
+        bool changed = false;
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (touched[i]) {
+                refresh(files[i]);
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    std::vector<CountResult> results() const {
+        std::vector<CountResult> out;
+        out.reserve(files.size());
+        double now = wallSeconds();
+        for (const Followed& file : files) {
+            CountResult result = file.engine.result();
+            result.stats = file.stats;
+            result.stats.wallSeconds = now - file.started;
+            result.stats.cpuSeconds = file.stats.countSeconds;
+            out.push_back(result);
+        }
+        return out;
+    }
+};
+
+} // namespace
+
+bool followFiles(const std::vector<std::string>& filenames, const CountOptions& options,
+                 double intervalSeconds, const FollowCallback& onUpdate) {
+    int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        return false;
+    }
+
+    {
+        StopSignals signals;
+        Follower follower(filenames, options, inotifyFd);
+        onUpdate(follower.results());
+
+        double nextReport = wallSeconds() + intervalSeconds;
+        bool changed = false;
+        while (!stopRequested) {
+            double now = wallSeconds();
+            if (changed && now >= nextReport) {
+                onUpdate(follower.results());
+                changed = false;
+            }
+            if (now >= nextReport) {
+                nextReport = now + intervalSeconds;
+            }
+
+            // Интервал может быть сколь угодно большим: ожидание ограничено
+            // пределом int, после него цикл просто проснётся и подождёт ещё
+            double waitMs = (nextReport - now) * 1000 + 1;
+            int timeoutMs = waitMs < kMaxPollMs ? static_cast<int>(waitMs) : kMaxPollMs;
+            pollfd waitFor = {inotifyFd, POLLIN, 0};
+            int ready = poll(&waitFor, 1, timeoutMs);
+            if (ready < 0 && errno != EINTR) {
+                break;
+            }
+            if (ready > 0 && follower.handleEvents()) {
+                changed = true;
+            }
+        }
+
+        // Изменения после последнего отчёта не теряются
+        if (changed) {
+            onUpdate(follower.results());
+        }
+    }
+
+    close(inotifyFd);
+    return true;
+}
+
+#else
+
+bool followFiles(const std::vector<std::string>&, const CountOptions&, double, const FollowCallback&) {
+    return false;
+}
+
+#endif // __linux__
@@ -0,0 +1,25 @@
+#ifndef FOLLOW_H
+#define FOLLOW_H
+
+#include "count_engine.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Текущие результаты всех наблюдаемых файлов в порядке filenames
+using FollowCallback = std::function<void(const std::vector<CountResult>& results)>;
+
+// Режим --follow (только Linux). Файлы считаются целиком один раз, затем
+// через inotify отслеживаются дописывания: читаются только новые байты,
+// а состояние счётчика (незаконченное слово, строка, символ UTF-8)
+// переносится через границу порций. Если имя стало указывать на другой
+// файл (ротация переименованием и созданием нового) или файл укоротился,
+// счёт начинается заново. Отсутствующий файл считается пустым, пока
+// не появится. onUpdate вызывается сразу и затем не чаще раза
+// в intervalSeconds, если что-то изменилось. Работает до SIGINT или
+// SIGTERM. Возвращает false, если inotify недоступен
+bool followFiles(const std::vector<std::string>& filenames, const CountOptions& options,
+                 double intervalSeconds, const FollowCallback& onUpdate);
+
+#endif // FOLLOW_H
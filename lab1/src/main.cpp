@@ -1,57 +1,243 @@
+#include "count_cache.h"
+#include "dir_scan.h"
+#include "estimate.h"
+#include "file_batch.h"
+#include "follow.h"
+#include "report.h"
+#include "stopwatch.h"
+
+#include <cstdlib>
 #include <iostream>
-#include <vector>
+#include <memory>
 #include <string>
-#include "word_count.h"
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#define isatty _isatty
+#else
+#include <unistd.h>
+#endif
 
 int main(int argc, char** argv) {
+    double programStart = wallSeconds();
 
     if (argc < 2) {
-        std::cerr << "Usage example: WordCount.exe [OPTION] filename [filename,...]\n";
+        std::cerr << "Usage example: WordCount.exe [-l] [-w] [-c] [-m] [--letters] [-L] [--line-hist] [-j N] [--cache FILE] [--uring] [--top K] [--format=text|json|tsv] [--stats] [--estimate[=REL_ERR]] [--follow [--interval SEC]] [-r DIR] [--include GLOB] [--exclude GLOB] filename [filename,...] (\"-\" for stdin)\n";
         return 1;
     }
 
     std::vector<std::string> filenames;
+    std::vector<std::string> directories;
+    ScanFilter filter;
 
-    bool linesOutput = false;
-    bool wordsOutput = false;
-    bool bytesOutput = false;
-    bool charsOutput = false;
+    ReportFields fields;
+    OutputFormat format = OutputFormat::Text;
+    CountOptions options;
+    bool follow = false;
+    double targetError = 0;
+    double interval = 1.0;
+    std::unique_ptr<CountCache> cache;
 
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
 
         if (arg == "-l") {
-            linesOutput = true;
+            fields.lines = true;
         } else if (arg == "-w") {
-            wordsOutput = true;
+            fields.words = true;
         } else if (arg == "-c") {
-            bytesOutput = true;
+            fields.bytes = true;
         } else if (arg == "-m") {
-            charsOutput = true;
+            fields.chars = true;
+            if (options.charMode == CharMode::AsciiLetters) {
+                options.charMode = CharMode::CodePoints;
+            }
+        } else if (arg == "--letters") {
+            fields.chars = true;
+            options.charMode = CharMode::Letters;
+        } else if (arg == "-L") {
+            fields.longestLine = true;
+            options.lineStats = true;
+        } else if (arg == "--line-hist") {
+            fields.lineHistogram = true;
+            options.lineStats = true;
+        } else if (arg == "--top") {
+            long parsed = i + 1 < argc ? std::strtol(argv[++i], nullptr, 10) : 0;
+            if (parsed < 1) {
+                std::cerr << "--top requires a positive number\n";
+                return 1;
+            }
+            options.topWords = static_cast<size_t>(parsed);
+            fields.topWords = true;
+        } else if (arg == "-r" || arg == "--include" || arg == "--exclude") {
+            if (i + 1 >= argc) {
+                std::cerr << arg << " requires an argument\n";
+                return 1;
+            }
+            std::string value = argv[++i];
+            if (arg == "-r") {
+                directories.push_back(value);
+            } else if (arg == "--include") {
+                filter.include.push_back(value);
+            } else {
+                filter.exclude.push_back(value);
+            }
+        } else if (arg.rfind("--format=", 0) == 0) {
+            std::string value = arg.substr(9);
+            if (value == "text") {
+                format = OutputFormat::Text;
+            } else if (value == "json") {
+                format = OutputFormat::Json;
+            } else if (value == "tsv") {
+                format = OutputFormat::Tsv;
+            } else {
+                std::cerr << "Unknown output format: " << value << "\n";
+                return 1;
+            }
+        } else if (arg == "--stats") {
+            fields.stats = true;
+        } else if (arg == "--estimate" || arg.rfind("--estimate=", 0) == 0) {
+            fields.estimate = true;
+            targetError = arg.size() > 11 ? std::strtod(arg.c_str() + 11, nullptr) : 0.01;
+            if (!(targetError > 0 && targetError < 1)) {
+                std::cerr << "--estimate requires a relative error between 0 and 1\n";
+                return 1;
+            }
+        } else if (arg == "--follow") {
+            follow = true;
+        } else if (arg == "--interval") {
+            interval = i + 1 < argc ? std::strtod(argv[++i], nullptr) : 0;
+            if (!(interval > 0)) {
+                std::cerr << "--interval requires a positive number of seconds\n";
+                return 1;
+            }
+        } else if (arg == "--uring") {
+            options.uring = true;
+        } else if (arg == "--cache") {
+            if (i + 1 >= argc) {
+                std::cerr << "--cache requires a file name\n";
+                return 1;
+            }
+            cache.reset(new CountCache(argv[++i]));
+            options.cache = cache.get();
+        } else if (arg.rfind("-j", 0) == 0) {
+            std::string value = arg.size() > 2 ? arg.substr(2) : (i + 1 < argc ? argv[++i] : "");
+            long parsed = std::strtol(value.c_str(), nullptr, 10);
+            if (parsed < 1) {
+                std::cerr << "Invalid number of jobs: " << value << "\n";
+                return 1;
+            }
+            options.jobs = static_cast<unsigned>(parsed);
         } else {
             filenames.push_back(arg);
         }
     }
 
-    for (const auto& filename : filenames) {
-        WordCounter counter(filename);
-        std::cout << "File " << filename << ": " << std::endl;
+    // Без имён файлов читаем стандартный ввод, если он перенаправлен
+    if (filenames.empty() && directories.empty() && !isatty(0)) {
+        filenames.push_back("-");
+    }
+
+    ReportWriter report(format, fields);
+    // 1, если какой-то файл не прочитался
+    int exitCode = 0;
 
-        if (linesOutput) {
-            std::cout << "number of lines = " << counter.countLines() << std::endl;
+    if (fields.estimate) {
+        if (follow || !directories.empty()) {
+            std::cerr << "--estimate does not support --follow or -r\n";
+            return 1;
         }
-        if (wordsOutput) {
-            std::cout << "number of words = " << counter.countWords() << std::endl;
+        EstimateResult total;
+        total.exact = true;
+        for (const auto& filename : filenames) {
+            EstimateResult estimate = estimateFile(filename, options, targetError);
+            if (estimate.readError) {
+                std::cerr << filename << ": read error\n";
+                exitCode = 1;
+                continue;
+            }
+            report.writeEstimate("file", filename, estimate);
+            total += estimate;
         }
-        if (bytesOutput) {
-            std::cout << "number of bytes = " << counter.countBytes() << std::endl;
+        if (filenames.size() > 1) {
+            report.writeEstimate("total", "", total);
         }
-        if (charsOutput) {
-            std::cout << "number of chars = " << counter.countChars() << std::endl;
+        report.finish();
+        return exitCode;
+    }
+
+    if (follow) {
+        if (!directories.empty() || filenames.empty()) {
+            std::cerr << "--follow requires file names and does not support -r\n";
+            return 1;
+        }
+        for (const auto& filename : filenames) {
+            if (filename == "-") {
+                std::cerr << "--follow cannot read standard input\n";
+                return 1;
+            }
+        }
+        options.cache = nullptr;
+
+        bool supported = followFiles(filenames, options, interval, [&](const std::vector<CountResult>& results) {
+            CountResult total;
+            for (size_t i = 0; i < results.size(); ++i) {
+                report.write("file", filenames[i], results[i]);
+                total += results[i];
+            }
+            if (results.size() > 1) {
+                report.write("total", "", total);
+            }
+            report.flush();
+        });
+        if (!supported) {
+            std::cerr << "--follow is not supported on this system\n";
+            return 1;
         }
+        report.finish();
+        return 0;
+    }
+
+    CountResult total;
+    size_t fileCount = 0;
+    auto onFile = [&](const std::string& filename, const CountResult& result) {
+        if (result.readError) {
+            std::cerr << filename << ": read error\n";
+            exitCode = 1;
+            return;
+        }
+        report.write("file", filename, result);
+        for (uint64_t offset : result.invalidUtf8Offsets) {
+            std::cerr << filename << ": invalid UTF-8 sequence at byte " << offset << "\n";
+        }
+        total += result;
+        ++fileCount;
+    };
+
+    countFiles(filenames, options, [&](size_t index, const CountResult& result) {
+        onFile(filenames[index], result);
+    });
+
+    for (const auto& root : directories) {
+        auto aggregates = scanDirectory(root, filter, options, onFile);
+        for (const auto& dir : aggregates) {
+            report.write("directory", dir.first, dir.second);
+        }
+    }
+
+    if (fileCount > 1) {
+        // Файлы считаются параллельно, поэтому для итога берётся время
+        // всего запуска, а не сумма времён файлов
+        total.stats.wallSeconds = wallSeconds() - programStart;
+        total.stats.cpuSeconds = processCpuSeconds();
+        report.write("total", "", total);
+    }
+    report.finish();
 
-        std::cout << std::endl;
+    if (cache && !cache->save()) {
+        std::cerr << "Failed to save count cache\n";
     }
 
-    return 0;
+    return exitCode;
 }
@@ -0,0 +1,63 @@
+#include "parallel_count.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Сдвигает границу части вперёд, чтобы не разрезать символ UTF-8
+size_t alignToCharacter(const char* data, size_t size, size_t pos) {
+    for (int k = 0; k < 3 && pos < size; ++k, ++pos) {
+        if ((static_cast<unsigned char>(data[pos]) & 0xC0) != 0x80) {
+            break;
+        }
+    }
+    return pos;
+}
+
+} // namespace
+
+CountResult countParallel(const char* data, size_t size, const CountOptions& options) {
+    return countChunks(data, size, options).result();
+}
+
+CountEngine countChunks(const char* data, size_t size, const CountOptions& options, size_t minChunkSize) {
+    unsigned jobs = options.jobs;
+    size_t maxChunks = size / minChunkSize;
+    size_t chunks = jobs < maxChunks ? jobs : maxChunks;
+
+    if (chunks <= 1) {
+        CountEngine engine(options);
+        engine.feed(data, size);
+        return engine;
+    }
+
+    std::vector<CountEngine> engines(chunks, CountEngine(options));
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+
+    size_t chunkSize = size / chunks;
+    for (size_t i = 0; i < chunks; ++i) {
+        size_t begin = i == 0 ? 0 : alignToCharacter(data, size, i * chunkSize);
+        size_t end = (i + 1 == chunks) ? size : alignToCharacter(data, size, (i + 1) * chunkSize);
+        CountEngine* engine = &engines[i];
+
+        if (i + 1 == chunks) {
+            // Последнюю часть считает текущий поток
+            engine->feed(data + begin, end - begin);
+        } else {
+            workers.emplace_back([engine, data, begin, end]() {
+                engine->feed(data + begin, end - begin);
+            });
+        }
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (size_t i = 1; i < chunks; ++i) {
+        engines[0].merge(engines[i]);
+    }
+    return engines[0];
+}
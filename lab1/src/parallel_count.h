@@ -0,0 +1,21 @@
+#ifndef PARALLEL_COUNT_H
+#define PARALLEL_COUNT_H
+
+#include "count_engine.h"
+
+#include <cstddef>
+
+// Делит данные на options.jobs частей, считает их в отдельных потоках и
+// сливает результаты. Итог совпадает с последовательным подсчётом
+CountResult countParallel(const char* data, size_t size, const CountOptions& options);
+
+// Меньшие части не окупают запуск потока
+const size_t kMinChunkSize = 4 << 20;
+
+// То же, но возвращает слитый счётчик, чтобы его можно было дополнить
+// новыми данными или сохранить. minChunkSize меняется только в тестах,
+// чтобы границы частей попадали в нужные места короткого входа
+CountEngine countChunks(const char* data, size_t size, const CountOptions& options,
+                        size_t minChunkSize = kMinChunkSize);
+
+#endif // PARALLEL_COUNT_H
@@ -0,0 +1,550 @@
+#include "report.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const size_t kFlushThreshold = 64 << 10;
+
+void appendNumber(std::string& out, uint64_t value) {
+    out += std::to_string(value);
+}
+
+void appendDouble(std::string& out, double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.6f", value);
+    out += text;
+}
+
+// Длина корректной последовательности UTF-8, начинающейся с value[i],
+// или 0 (диапазоны второго байта — по таблице 3-7 стандарта Unicode:
+// без overlong-форм, суррогатов и символов за U+10FFFF)
+size_t utf8SequenceLength(const std::string& value, size_t i) {
+    unsigned char lead = static_cast<unsigned char>(value[i]);
+    size_t length = 0;
+    unsigned char lower = 0x80;
+    unsigned char upper = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        lower = lead == 0xE0 ? 0xA0 : 0x80;
+        upper = lead == 0xED ? 0x9F : 0xBF;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        lower = lead == 0xF0 ? 0x90 : 0x80;
+        upper = lead == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return 0;
+    }
+    if (i + length > value.size()) {
+        return 0;
+    }
+    for (size_t k = 1; k < length; ++k) {
+        unsigned char c = static_cast<unsigned char>(value[i + k]);
+        if (c < (k == 1 ? lower : 0x80) || c > (k == 1 ? upper : 0xBF)) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+// Имена файлов и слова — произвольные байты, а JSON должен быть
+// корректным UTF-8: каждый байт некорректной последовательности
+// заменяется на U+FFFD
+void appendJsonString(std::string& out, const std::string& value) {
+    out += '"';
+    for (size_t i = 0; i < value.size();) {
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x80) {
+            size_t length = utf8SequenceLength(value, i);
+            if (length == 0) {
+                out += "\\ufffd";
+                ++i;
+            } else {
+                out.append(value, i, length);
+                i += length;
+            }
+            continue;
+        }
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += static_cast<char>(c);
+        }
+        ++i;
+    }
+    out += '"';
+}
+
+// Табуляции и переводы строк в имени сломали бы TSV
+std::string tsvField(const std::string& value) {
+    std::string result;
+    for (char c : value) {
+        if (c == '\t') {
+            result += "\\t";
+        } else if (c == '\n') {
+            result += "\\n";
+        } else if (c == '\\') {
+            result += "\\\\";
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+double meanLineLength(const CountResult& result) {
+    return result.lines > 0 ? static_cast<double>(result.lineLengthSum) / static_cast<double>(result.lines) : 0;
+}
+
+// Границы корзины гистограммы длин строк (см. LineStats)
+void appendBucket(std::string& out, size_t bucket) {
+    uint64_t low = bucket == 0 ? 0 : uint64_t(1) << (bucket - 1);
+    uint64_t high = bucket == 0 ? 0 : (bucket == 64 ? ~uint64_t(0) : (uint64_t(1) << bucket) - 1);
+    appendNumber(out, low);
+    if (high != low) {
+        out += '-';
+        appendNumber(out, high);
+    }
+}
+
+double gigabytesPerSecond(const CountStats& stats) {
+    return stats.wallSeconds > 0 ? static_cast<double>(stats.bytesRead) / stats.wallSeconds / 1e9 : 0;
+}
+
+} // namespace
+
+ReportWriter::ReportWriter(OutputFormat format, const ReportFields& fields, std::FILE* out)
+    : format(format), fields(fields), out(out) {}
+
+ReportWriter::~ReportWriter() {
+    finish();
+}
+
+void ReportWriter::begin() {
+    if (started) {
+        return;
+    }
+    started = true;
+
+    if (format == OutputFormat::Json) {
+        buffer += "[\n";
+    } else if (format == OutputFormat::Tsv && fields.estimate) {
+        buffer += "kind\tname";
+        for (const char* metric : {"lines", "words", "chars"}) {
+            buffer += std::string("\t") + metric + "\t" + metric + "_low\t" + metric + "_high";
+        }
+        buffer += "\tbytes\tsampled_bytes\tblocks\texact\n";
+    } else if (format == OutputFormat::Tsv) {
+        buffer += "kind\tname";
+        if (fields.lines) {
+            buffer += "\tlines";
+        }
+        if (fields.words) {
+            buffer += "\twords";
+        }
+        if (fields.bytes) {
+            buffer += "\tbytes";
+        }
+        if (fields.chars) {
+            buffer += "\tchars\tinvalid_utf8";
+        }
+        if (fields.longestLine) {
+            buffer += "\tlongest_line\tmean_line";
+        }
+        if (fields.lineHistogram) {
+            buffer += "\tline_histogram";
+        }
+        if (fields.stats) {
+            buffer += "\tbytes_read\twall_s\tcpu_s\tio_s\tcount_s\tgb_per_s";
+        }
+        if (fields.topWords) {
+            buffer += "\ttop_words";
+        }
+        buffer += '\n';
+    }
+}
+
+void ReportWriter::write(const std::string& kind, const std::string& name, const CountResult& result) {
+    begin();
+    if (format == OutputFormat::Json) {
+        writeJson(kind, name, result);
+    } else if (format == OutputFormat::Tsv) {
+        writeTsv(kind, name, result);
+    } else {
+        writeText(kind, name, result);
+    }
+    flushIfFull();
+}
+
+void ReportWriter::writeText(const std::string& kind, const std::string& name, const CountResult& result) {
+    if (kind == "file") {
+        buffer += "File " + name + ": \n";
+    } else if (kind == "directory") {
+        buffer += "Directory " + name + ": \n";
+    } else {
+        buffer += "Total: \n";
+    }
+
+    if (fields.lines) {
+        buffer += "number of lines = ";
+        appendNumber(buffer, result.lines);
+        buffer += '\n';
+    }
+    if (fields.words) {
+        buffer += "number of words = ";
+        appendNumber(buffer, result.words);
+        buffer += '\n';
+    }
+    if (fields.bytes) {
+        buffer += "number of bytes = ";
+        appendNumber(buffer, result.bytes);
+        buffer += '\n';
+    }
+    if (fields.chars) {
+        buffer += "number of chars = ";
+        appendNumber(buffer, result.chars);
+        buffer += '\n';
+        if (result.invalidUtf8 > 0) {
+            buffer += "invalid UTF-8 sequences = ";
+            appendNumber(buffer, result.invalidUtf8);
+            buffer += '\n';
+        }
+    }
+    if (fields.longestLine) {
+        buffer += "longest line = ";
+        appendNumber(buffer, result.longestLine);
+        buffer += "\nmean line length = ";
+        appendDouble(buffer, meanLineLength(result));
+        buffer += '\n';
+    }
+    if (fields.lineHistogram) {
+        buffer += "line length histogram:\n";
+        for (size_t i = 0; i < result.lineHistogram.size(); ++i) {
+            if (result.lineHistogram[i] == 0) {
+                continue;
+            }
+            buffer += "  ";
+            appendBucket(buffer, i);
+            buffer += ": ";
+            appendNumber(buffer, result.lineHistogram[i]);
+            buffer += '\n';
+        }
+    }
+    if (!result.topWords.empty()) {
+        buffer += "top words:\n";
+        for (const auto& item : result.topWords) {
+            buffer += "  ";
+            appendNumber(buffer, item.second);
+            buffer += ' ' + item.first + '\n';
+        }
+    }
+    if (fields.stats && kind != "directory") {
+        const CountStats& stats = result.stats;
+        buffer += "bytes read = ";
+        appendNumber(buffer, stats.bytesRead);
+        buffer += "\nwall time = ";
+        appendDouble(buffer, stats.wallSeconds);
+        buffer += " s\ncpu time = ";
+        appendDouble(buffer, stats.cpuSeconds);
+        buffer += " s\nio time = ";
+        appendDouble(buffer, stats.ioSeconds);
+        buffer += " s\ncount time = ";
+        appendDouble(buffer, stats.countSeconds);
+        buffer += " s\nthroughput = ";
+        appendDouble(buffer, gigabytesPerSecond(stats));
+        buffer += " GB/s\n";
+    }
+
+    buffer += '\n';
+}
+
+void ReportWriter::writeJson(const std::string& kind, const std::string& name, const CountResult& result) {
+    buffer += first ? "  {" : ",\n  {";
+    first = false;
+
+    buffer += "\"kind\": ";
+    appendJsonString(buffer, kind);
+    buffer += ", \"name\": ";
+    appendJsonString(buffer, name);
+
+    if (fields.lines) {
+        buffer += ", \"lines\": ";
+        appendNumber(buffer, result.lines);
+    }
+    if (fields.words) {
+        buffer += ", \"words\": ";
+        appendNumber(buffer, result.words);
+    }
+    if (fields.bytes) {
+        buffer += ", \"bytes\": ";
+        appendNumber(buffer, result.bytes);
+    }
+    if (fields.chars) {
+        buffer += ", \"chars\": ";
+        appendNumber(buffer, result.chars);
+        buffer += ", \"invalid_utf8\": ";
+        appendNumber(buffer, result.invalidUtf8);
+    }
+    if (fields.longestLine) {
+        buffer += ", \"longest_line\": ";
+        appendNumber(buffer, result.longestLine);
+        buffer += ", \"mean_line\": ";
+        appendDouble(buffer, meanLineLength(result));
+    }
+    if (fields.lineHistogram) {
+        buffer += ", \"line_histogram\": [";
+        bool firstBucket = true;
+        for (size_t i = 0; i < result.lineHistogram.size(); ++i) {
+            if (result.lineHistogram[i] == 0) {
+                continue;
+            }
+            buffer += firstBucket ? "{\"range\": \"" : ", {\"range\": \"";
+            firstBucket = false;
+            appendBucket(buffer, i);
+            buffer += "\", \"count\": ";
+            appendNumber(buffer, result.lineHistogram[i]);
+            buffer += '}';
+        }
+        buffer += ']';
+    }
+    if (!result.topWords.empty()) {
+        buffer += ", \"top_words\": [";
+        for (size_t i = 0; i < result.topWords.size(); ++i) {
+            buffer += i == 0 ? "{\"word\": " : ", {\"word\": ";
+            appendJsonString(buffer, result.topWords[i].first);
+            buffer += ", \"count\": ";
+            appendNumber(buffer, result.topWords[i].second);
+            buffer += '}';
+        }
+        buffer += ']';
+    }
+    if (fields.stats && kind != "directory") {
+        const CountStats& stats = result.stats;
+        buffer += ", \"stats\": {\"bytes_read\": ";
+        appendNumber(buffer, stats.bytesRead);
+        buffer += ", \"wall_s\": ";
+        appendDouble(buffer, stats.wallSeconds);
+        buffer += ", \"cpu_s\": ";
+        appendDouble(buffer, stats.cpuSeconds);
+        buffer += ", \"io_s\": ";
+        appendDouble(buffer, stats.ioSeconds);
+        buffer += ", \"count_s\": ";
+        appendDouble(buffer, stats.countSeconds);
+        buffer += ", \"gb_per_s\": ";
+        appendDouble(buffer, gigabytesPerSecond(stats));
+        buffer += '}';
+    }
+
+    buffer += '}';
+}
+
+void ReportWriter::writeTsv(const std::string& kind, const std::string& name, const CountResult& result) {
+    buffer += kind + '\t' + tsvField(name);
+
+    if (fields.lines) {
+        buffer += '\t';
+        appendNumber(buffer, result.lines);
+    }
+    if (fields.words) {
+        buffer += '\t';
+        appendNumber(buffer, result.words);
+    }
+    if (fields.bytes) {
+        buffer += '\t';
+        appendNumber(buffer, result.bytes);
+    }
+    if (fields.chars) {
+        buffer += '\t';
+        appendNumber(buffer, result.chars);
+        buffer += '\t';
+        appendNumber(buffer, result.invalidUtf8);
+    }
+    if (fields.longestLine) {
+        buffer += '\t';
+        appendNumber(buffer, result.longestLine);
+        buffer += '\t';
+        appendDouble(buffer, meanLineLength(result));
+    }
+    if (fields.lineHistogram) {
+        // Пары "диапазон:число" через пробел
+        buffer += '\t';
+        bool firstBucket = true;
+        for (size_t i = 0; i < result.lineHistogram.size(); ++i) {
+            if (result.lineHistogram[i] == 0) {
+                continue;
+            }
+            if (!firstBucket) {
+                buffer += ' ';
+            }
+            firstBucket = false;
+            appendBucket(buffer, i);
+            buffer += ':';
+            appendNumber(buffer, result.lineHistogram[i]);
+        }
+    }
+    if (fields.stats && kind != "directory") {
+        const CountStats& stats = result.stats;
+        buffer += '\t';
+        appendNumber(buffer, stats.bytesRead);
+        for (double value : {stats.wallSeconds, stats.cpuSeconds, stats.ioSeconds,
+                             stats.countSeconds, gigabytesPerSecond(stats)}) {
+            buffer += '\t';
+            appendDouble(buffer, value);
+        }
+    } else if (fields.stats) {
+        // У каталогов замеров нет, как в тексте и JSON: столбцы пустые
+        buffer += "\t\t\t\t\t\t";
+    }
+
+    // Слова не содержат пробелов, поэтому пары "частота:слово" разделяются пробелом
+    if (fields.topWords) {
+        buffer += '\t';
+        for (size_t i = 0; i < result.topWords.size(); ++i) {
+            if (i > 0) {
+                buffer += ' ';
+            }
+            appendNumber(buffer, result.topWords[i].second);
+            buffer += ':' + tsvField(result.topWords[i].first);
+        }
+    }
+    buffer += '\n';
+}
+
+// Строка текстового отчёта или поле JSON/TSV для одной оценки
+void ReportWriter::appendEstimate(const char* label, const EstimatedValue& value, bool exact) {
+    double halfWidth = kConfidenceZ * value.stdError;
+    uint64_t estimate = static_cast<uint64_t>(std::llround(value.value));
+    uint64_t low = static_cast<uint64_t>(std::llround(std::max(0.0, value.value - halfWidth)));
+    uint64_t high = static_cast<uint64_t>(std::llround(value.value + halfWidth));
+
+    if (format == OutputFormat::Json) {
+        buffer += ", \"";
+        buffer += label;
+        buffer += "\": {\"estimate\": ";
+        appendNumber(buffer, estimate);
+        buffer += ", \"low\": ";
+        appendNumber(buffer, low);
+        buffer += ", \"high\": ";
+        appendNumber(buffer, high);
+        buffer += '}';
+    } else if (format == OutputFormat::Tsv) {
+        for (uint64_t number : {estimate, low, high}) {
+            buffer += '\t';
+            appendNumber(buffer, number);
+        }
+    } else if (exact) {
+        buffer += "number of ";
+        buffer += label;
+        buffer += " = ";
+        appendNumber(buffer, estimate);
+        buffer += '\n';
+    } else {
+        buffer += "number of ";
+        buffer += label;
+        buffer += " ~ ";
+        appendNumber(buffer, estimate);
+        buffer += " +- ";
+        appendDouble(buffer, value.value > 0 ? 100 * halfWidth / value.value : 0);
+        buffer += "% (95%: ";
+        appendNumber(buffer, low);
+        buffer += "..";
+        appendNumber(buffer, high);
+        buffer += ")\n";
+    }
+}
+
+void ReportWriter::writeEstimate(const std::string& kind, const std::string& name, const EstimateResult& estimate) {
+    begin();
+
+    if (format == OutputFormat::Json) {
+        buffer += first ? "  {" : ",\n  {";
+        first = false;
+        buffer += "\"kind\": ";
+        appendJsonString(buffer, kind);
+        buffer += ", \"name\": ";
+        appendJsonString(buffer, name);
+        appendEstimate("lines", estimate.lines, estimate.exact);
+        appendEstimate("words", estimate.words, estimate.exact);
+        appendEstimate("chars", estimate.chars, estimate.exact);
+        buffer += ", \"bytes\": ";
+        appendNumber(buffer, estimate.bytes);
+        buffer += ", \"sampled_bytes\": ";
+        appendNumber(buffer, estimate.sampledBytes);
+        buffer += ", \"blocks\": ";
+        appendNumber(buffer, estimate.blocks);
+        buffer += estimate.exact ? ", \"exact\": true}" : ", \"exact\": false}";
+    } else if (format == OutputFormat::Tsv) {
+        buffer += kind + '\t' + tsvField(name);
+        appendEstimate("lines", estimate.lines, estimate.exact);
+        appendEstimate("words", estimate.words, estimate.exact);
+        appendEstimate("chars", estimate.chars, estimate.exact);
+        for (uint64_t number : {estimate.bytes, estimate.sampledBytes, estimate.blocks}) {
+            buffer += '\t';
+            appendNumber(buffer, number);
+        }
+        buffer += estimate.exact ? "\t1\n" : "\t0\n";
+    } else {
+        if (kind == "file") {
+            buffer += "File " + name + ": \n";
+        } else {
+            buffer += "Total: \n";
+        }
+        if (fields.lines) {
+            appendEstimate("lines", estimate.lines, estimate.exact);
+        }
+        if (fields.words) {
+            appendEstimate("words", estimate.words, estimate.exact);
+        }
+        if (fields.bytes) {
+            buffer += "number of bytes = ";
+            appendNumber(buffer, estimate.bytes);
+            buffer += '\n';
+        }
+        if (fields.chars) {
+            appendEstimate("chars", estimate.chars, estimate.exact);
+        }
+        if (!estimate.exact) {
+            buffer += "sampled ";
+            appendNumber(buffer, estimate.sampledBytes);
+            buffer += " bytes in ";
+            appendNumber(buffer, estimate.blocks);
+            buffer += " blocks\n";
+        }
+        buffer += '\n';
+    }
+    flushIfFull();
+}
+
+void ReportWriter::flushIfFull() {
+    if (buffer.size() >= kFlushThreshold) {
+        flush();
+    }
+}
+
+void ReportWriter::flush() {
+    if (!buffer.empty()) {
+        std::fwrite(buffer.data(), 1, buffer.size(), out);
+        buffer.clear();
+    }
+    std::fflush(out);
+}
+
+void ReportWriter::finish() {
+    if (finished) {
+        return;
+    }
+    finished = true;
+    if (format == OutputFormat::Json) {
+        begin();
+        buffer += first ? "]\n" : "\n]\n";
+    }
+    flush();
+}
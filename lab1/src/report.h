@@ -0,0 +1,64 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include "count_engine.h"
+#include "estimate.h"
+
+#include <cstdio>
+#include <string>
+
+enum class OutputFormat { Text, Json, Tsv };
+
+// Какие поля выводить
+struct ReportFields {
+    bool lines = false;
+    bool words = false;
+    bool bytes = false;
+    bool chars = false;
+    bool longestLine = false;
+    bool lineHistogram = false;
+    bool stats = false;
+    // Самые частые слова (--top): в TSV для них есть отдельный столбец
+    bool topWords = false;
+    // Приблизительный подсчёт: вместо write используется writeEstimate
+    bool estimate = false;
+};
+
+// Вывод результатов через один буфер: строки копятся в памяти и
+// сбрасываются крупными блоками, без сброса потока на каждой строке.
+// Text — прежний человекочитаемый формат, Json — массив объектов,
+// Tsv — строка заголовка и по строке на запись
+class ReportWriter {
+private:
+    OutputFormat format;
+    ReportFields fields;
+    std::FILE* out;
+    std::string buffer;
+    bool started = false;
+    bool finished = false;
+    bool first = true;
+
+    void begin();
+    void flushIfFull();
+    void writeText(const std::string& kind, const std::string& name, const CountResult& result);
+    void writeJson(const std::string& kind, const std::string& name, const CountResult& result);
+    void writeTsv(const std::string& kind, const std::string& name, const CountResult& result);
+    void appendEstimate(const char* label, const EstimatedValue& value, bool exact);
+
+public:
+    ReportWriter(OutputFormat format, const ReportFields& fields, std::FILE* out = stdout);
+    ~ReportWriter();
+
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+
+    // kind: "file", "directory" или "total"
+    void write(const std::string& kind, const std::string& name, const CountResult& result);
+    void writeEstimate(const std::string& kind, const std::string& name, const EstimateResult& estimate);
+
+    // Завершает документ (закрывающая скобка JSON) и сбрасывает буфер
+    void finish();
+    void flush();
+};
+
+#endif // REPORT_H
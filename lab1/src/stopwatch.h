@@ -0,0 +1,11 @@
+#ifndef STOPWATCH_H
+#define STOPWATCH_H
+
+// Монотонное время в секундах (для разностей)
+double wallSeconds();
+
+// Процессорное время текущего потока и всего процесса в секундах
+double threadCpuSeconds();
+double processCpuSeconds();
+
+#endif // STOPWATCH_H
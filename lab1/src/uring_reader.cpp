@@ -0,0 +1,344 @@
+#include "stopwatch.h"
+#include "uring_reader.h"
+#include "word_count.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define WORDCOUNT_HAS_URING 1
+#endif
+#endif
+
+#ifdef WORDCOUNT_HAS_URING
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+const unsigned kQueueDepth = 64;
+const size_t kReadSize = 128 << 10;
+
+// Минимальная обёртка над кольцами io_uring (без liburing)
+class Ring {
+private:
+    int fd = -1;
+    void* sqPtr = nullptr;
+    void* cqPtr = nullptr;
+    size_t sqSize = 0;
+    size_t cqSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqesSize = 0;
+
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    unsigned pending = 0;
+
+    static unsigned* field(void* base, unsigned offset) {
+        return reinterpret_cast<unsigned*>(static_cast<char*>(base) + offset);
+    }
+
+public:
+    ~Ring() {
+        if (sqes != nullptr) {
+            munmap(sqes, sqesSize);
+        }
+        if (cqPtr != nullptr && cqPtr != sqPtr) {
+            munmap(cqPtr, cqSize);
+        }
+        if (sqPtr != nullptr) {
+            munmap(sqPtr, sqSize);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool init(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return false;
+        }
+
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            sqSize = cqSize = sqSize > cqSize ? sqSize : cqSize;
+        }
+
+        sqPtr = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     fd, IORING_OFF_SQ_RING);
+        if (sqPtr == MAP_FAILED) {
+            sqPtr = nullptr;
+            return false;
+        }
+        if (singleMap) {
+            cqPtr = sqPtr;
+        } else {
+            cqPtr = mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         fd, IORING_OFF_CQ_RING);
+            if (cqPtr == MAP_FAILED) {
+                cqPtr = nullptr;
+                return false;
+            }
+        }
+
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqesPtr = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             fd, IORING_OFF_SQES);
+        if (sqesPtr == MAP_FAILED) {
+            return false;
+        }
+        sqes = static_cast<io_uring_sqe*>(sqesPtr);
+
+        sqTail = field(sqPtr, params.sq_off.tail);
+        sqArray = field(sqPtr, params.sq_off.array);
+        sqMask = *field(sqPtr, params.sq_off.ring_mask);
+        cqHead = field(cqPtr, params.cq_off.head);
+        cqTail = field(cqPtr, params.cq_off.tail);
+        cqMask = *field(cqPtr, params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(static_cast<char*>(cqPtr) + params.cq_off.cqes);
+        return supportsRead();
+    }
+
+    // Ядро может создать кольцо, но не знать IORING_OP_READ (до 5.6):
+    // тогда каждое чтение завершалось бы с -EINVAL. Проба операций
+    // появилась в том же 5.6, поэтому её отсутствие тоже означает отказ
+    bool supportsRead() {
+        const unsigned kProbeOps = 256;
+        std::vector<uint64_t> storage((sizeof(io_uring_probe) + kProbeOps * sizeof(io_uring_probe_op))
+                                      / sizeof(uint64_t) + 1);
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+        if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, kProbeOps) < 0) {
+            return false;
+        }
+        return probe->last_op >= IORING_OP_READ
+               && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+
+    // Очередь никогда не переполняется: в полёте не больше kQueueDepth чтений
+    void queueRead(int fileFd, char* buffer, size_t size, uint64_t offset, uint64_t userData) {
+        unsigned tail = *sqTail;
+        unsigned index = tail & sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fileFd;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer);
+        sqe->len = static_cast<unsigned>(size);
+        sqe->off = offset;
+        sqe->user_data = userData;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++pending;
+    }
+
+    // Отправляет накопленные запросы и ждёт хотя бы одного завершения
+    bool submitAndWait() {
+        while (true) {
+            long ret = syscall(__NR_io_uring_enter, fd, pending, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (ret >= 0) {
+                pending -= static_cast<unsigned>(ret) < pending ? static_cast<unsigned>(ret) : pending;
+                return true;
+            }
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    template <typename Handler>
+    void drainCompletions(Handler handler) {
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes[head & cqMask];
+            uint64_t userData = cqe.user_data;
+            int res = cqe.res;
+            ++head;
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+            handler(userData, res);
+        }
+    }
+};
+
+// Файл, читаемый в одном из слотов кольца
+struct Slot {
+    size_t index = 0;
+    int fd = -1;
+    bool ownsFd = true;
+    bool stream = false;
+    uint64_t offset = 0;
+    std::vector<char> buffer;
+    CountEngine engine;
+    double started = 0;
+    double countSeconds = 0;
+};
+
+} // namespace
+
+bool countFilesUring(const std::vector<std::string>& filenames, const CountOptions& options,
+                     const FileResultCallback& onResult) {
+    // Слоты объявлены раньше кольца и разрушаются после него: если кольцо
+    // сломалось, ядро ещё может писать в буферы незавершённых чтений
+    size_t slotCount = filenames.size() < kQueueDepth ? filenames.size() : kQueueDepth;
+    std::vector<Slot> slots(slotCount);
+
+    Ring ring;
+    if (options.cache != nullptr || !ring.init(kQueueDepth)) {
+        return false;
+    }
+
+    std::vector<CountResult> results(filenames.size());
+    std::vector<char> ready(filenames.size(), 0);
+    size_t nextFile = 0;
+    size_t nextToEmit = 0;
+    size_t inFlight = 0;
+
+    auto issueRead = [&](size_t slotIndex) {
+        Slot& slot = slots[slotIndex];
+        // Для каналов читаем с текущей позиции
+        uint64_t offset = slot.stream ? static_cast<uint64_t>(-1) : slot.offset;
+        ring.queueRead(slot.fd, slot.buffer.data(), slot.buffer.size(), offset, slotIndex);
+        ++inFlight;
+    };
+
+    auto closeSlot = [&](Slot& slot) {
+        ready[slot.index] = 1;
+        if (slot.ownsFd) {
+            close(slot.fd);
+        }
+        slot.fd = -1;
+    };
+
+    auto finishFile = [&](Slot& slot) {
+        CountResult& result = results[slot.index];
+        result = slot.engine.result();
+        // Подсчёт идёт в потоке кольца, остальное время — ожидание чтения
+        result.stats.bytesRead = result.bytes;
+        result.stats.wallSeconds = wallSeconds() - slot.started;
+        result.stats.countSeconds = slot.countSeconds;
+        result.stats.cpuSeconds = slot.countSeconds;
+        result.stats.ioSeconds = result.stats.wallSeconds - slot.countSeconds;
+        closeSlot(slot);
+    };
+
+    // Чтение через кольцо вернуло ошибку или кольцо сломалось: обычный файл пересчитывается
+    // обычным путём (он сам сообщит, если ошибка повторится), а канал
+    // уже частично вычитан, и его результат — ошибка
+    auto failFile = [&](Slot& slot) {
+        closeSlot(slot);
+        results[slot.index] = slot.stream ? readErrorResult() : WordCounter(filenames[slot.index]).count(options);
+    };
+
+    // Открывает следующий файл в слоте; неоткрываемые файлы сразу дают нули
+    auto startNext = [&](size_t slotIndex) {
+        Slot& slot = slots[slotIndex];
+        while (nextFile < filenames.size()) {
+            size_t index = nextFile++;
+            const std::string& name = filenames[index];
+            double opening = wallSeconds();
+            int fd = name == "-" ? STDIN_FILENO : open(name.c_str(), O_RDONLY);
+            if (fd < 0) {
+                ready[index] = 1;
+                continue;
+            }
+            struct stat st;
+            slot.index = index;
+            slot.fd = fd;
+            slot.ownsFd = fd != STDIN_FILENO;
+            slot.stream = fstat(fd, &st) != 0 || (st.st_mode & S_IFMT) != S_IFREG;
+            slot.offset = 0;
+            slot.engine = CountEngine(options);
+            slot.started = opening;
+            slot.countSeconds = 0;
+            if (slot.buffer.empty()) {
+                slot.buffer.resize(kReadSize);
+            }
+            issueRead(slotIndex);
+            return;
+        }
+    };
+
+    auto emitReady = [&]() {
+        while (nextToEmit < filenames.size() && ready[nextToEmit]) {
+            onResult(nextToEmit, results[nextToEmit]);
+            ++nextToEmit;
+        }
+    };
+
+    for (size_t i = 0; i < slotCount; ++i) {
+        startNext(i);
+    }
+    emitReady();
+
+    while (inFlight > 0) {
+        if (!ring.submitAndWait()) {
+            break;
+        }
+        ring.drainCompletions([&](uint64_t userData, int res) {
+            size_t slotIndex = static_cast<size_t>(userData);
+            Slot& slot = slots[slotIndex];
+            --inFlight;
+
+            if (res == -EINTR || res == -EAGAIN) {
+                issueRead(slotIndex);
+                return;
+            }
+            if (res < 0) {
+                failFile(slot);
+                startNext(slotIndex);
+                return;
+            }
+            if (res == 0) {
+                finishFile(slot);
+                startNext(slotIndex);
+                return;
+            }
+
+            double feedStart = wallSeconds();
+            slot.engine.feed(slot.buffer.data(), static_cast<size_t>(res));
+            slot.countSeconds += wallSeconds() - feedStart;
+            slot.offset += static_cast<uint64_t>(res);
+            issueRead(slotIndex);
+        });
+        emitReady();
+    }
+
+    // Кольцо сломалось посреди работы: недочитанные файлы обрабатываются
+    // как при ошибке чтения, оставшиеся считаются обычным путём
+    for (Slot& slot : slots) {
+        if (slot.fd >= 0) {
+            failFile(slot);
+        }
+    }
+    for (size_t i = nextFile; i < filenames.size(); ++i) {
+        results[i] = WordCounter(filenames[i]).count(options);
+        ready[i] = 1;
+    }
+    emitReady();
+    return true;
+}
+
+#else
+
+bool countFilesUring(const std::vector<std::string>&, const CountOptions&,
+                     const FileResultCallback&) {
+    return false;
+}
+
+#endif // WORDCOUNT_HAS_URING
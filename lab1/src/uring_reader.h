@@ -0,0 +1,17 @@
+#ifndef URING_READER_H
+#define URING_READER_H
+
+#include "file_batch.h"
+
+#include <string>
+#include <vector>
+
+// Подсчёт набора файлов через io_uring (только Linux). Одновременно открыто
+// до 64 файлов, по каждому в очереди одно чтение, так что глубина очереди
+// диска равна числу открытых файлов. Завершённые буферы сразу подаются
+// в счётчики, результаты отдаются в порядке filenames, как у countFiles.
+// Возвращает false, если io_uring недоступен; onResult тогда не вызывался
+bool countFilesUring(const std::vector<std::string>& filenames, const CountOptions& options,
+                     const FileResultCallback& onResult);
+
+#endif // URING_READER_H
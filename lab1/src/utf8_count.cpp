@@ -0,0 +1,341 @@
+#include "utf8_count.h"
+
+#include <istream>
+#include <ostream>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define WORDCOUNT_X86_UTF8 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const size_t kBlockSize = 64;
+
+bool isContinuation(unsigned char c) {
+    return (c & 0xC0) == 0x80;
+}
+
+bool isLetterCodePoint(uint32_t cp) {
+    if (cp < 0x80) {
+        return static_cast<uint32_t>((cp | 0x20) - 'a') < 26;
+    }
+    if (cp == 0xAA || cp == 0xB5 || cp == 0xBA) {
+        return true;
+    }
+    // Латиница: Latin-1, Latin Extended-A/B (кроме знаков × и ÷)
+    if (cp >= 0xC0 && cp <= 0x24F) {
+        return cp != 0xD7 && cp != 0xF7;
+    }
+    // Греческий
+    if (cp >= 0x386 && cp <= 0x3FF) {
+        return cp != 0x387 && cp != 0x3F6;
+    }
+    // Кириллица (кроме знаков U+0482–U+0489)
+    if (cp >= 0x400 && cp <= 0x52F) {
+        return cp < 0x482 || cp > 0x489;
+    }
+    return false;
+}
+
+// Длина префикса блока без оборванной в конце последовательности
+size_t completePrefix(const unsigned char* block) {
+    for (size_t k = 1; k <= 3; ++k) {
+        unsigned char c = block[kBlockSize - k];
+        if (c < 0x80) {
+            break;
+        }
+        if (c >= 0xC0) {
+            size_t length = c >= 0xF0 ? 4 : (c >= 0xE0 ? 3 : 2);
+            return length > k ? kBlockSize - k : kBlockSize;
+        }
+    }
+    return kBlockSize;
+}
+
+#ifdef WORDCOUNT_X86_UTF8
+
+// Флаги ошибок для пар соседних байт (simdjson/simdutf "lookup")
+const uint8_t kTooShort = 1 << 0;
+const uint8_t kTooLong = 1 << 1;
+const uint8_t kOverlong3 = 1 << 2;
+const uint8_t kTooLarge = 1 << 3;
+const uint8_t kSurrogate = 1 << 4;
+const uint8_t kOverlong2 = 1 << 5;
+const uint8_t kTooLarge1000 = 1 << 6;
+const uint8_t kOverlong4 = 1 << 6;
+const uint8_t kTwoConts = 1 << 7;
+const uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+__attribute__((target("avx2")))
+inline __m256i table16(uint8_t v0, uint8_t v1, uint8_t v2, uint8_t v3,
+                       uint8_t v4, uint8_t v5, uint8_t v6, uint8_t v7,
+                       uint8_t v8, uint8_t v9, uint8_t v10, uint8_t v11,
+                       uint8_t v12, uint8_t v13, uint8_t v14, uint8_t v15) {
+    return _mm256_setr_epi8(
+        v0, v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14, v15,
+        v0, v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14, v15);
+}
+
+__attribute__((target("avx2")))
+inline __m256i highNibble(__m256i v) {
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+// Байты input, сдвинутые на N позиций назад с подстановкой хвоста prev
+template <int N>
+__attribute__((target("avx2")))
+inline __m256i previous(__m256i input, __m256i prev) {
+    return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+}
+
+__attribute__((target("avx2")))
+__m256i checkUtf8(__m256i input, __m256i prev) {
+    __m256i prev1 = previous<1>(input, prev);
+
+    __m256i byte1High = _mm256_shuffle_epi8(table16(
+        kTooLong, kTooLong, kTooLong, kTooLong,
+        kTooLong, kTooLong, kTooLong, kTooLong,
+        kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+        kTooShort | kOverlong2,
+        kTooShort,
+        kTooShort | kOverlong3 | kSurrogate,
+        kTooShort | kTooLarge | kTooLarge1000 | kOverlong4), highNibble(prev1));
+
+    __m256i byte1Low = _mm256_shuffle_epi8(table16(
+        kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+        kCarry | kOverlong2,
+        kCarry,
+        kCarry,
+        kCarry | kTooLarge,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+        kCarry | kTooLarge | kTooLarge1000,
+        kCarry | kTooLarge | kTooLarge1000), _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+
+    __m256i byte2High = _mm256_shuffle_epi8(table16(
+        kTooShort, kTooShort, kTooShort, kTooShort,
+        kTooShort, kTooShort, kTooShort, kTooShort,
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+        kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+        kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+        kTooShort, kTooShort, kTooShort, kTooShort), highNibble(input));
+
+    __m256i special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+    // Третий и четвёртый байты 3- и 4-байтных последовательностей
+    __m256i third = _mm256_subs_epu8(previous<2>(input, prev), _mm256_set1_epi8(char(0xE0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(previous<3>(input, prev), _mm256_set1_epi8(char(0xF0 - 0x80)));
+    __m256i mustContinue = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+
+    return _mm256_xor_si256(mustContinue, special);
+}
+
+// Проверяет блок, начинающийся на границе символа. Оборванная в конце
+// последовательность ошибкой не считается: её проверит следующий блок
+__attribute__((target("avx2")))
+bool avx2BlockValid(const unsigned char* block) {
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    __m256i error = _mm256_or_si256(checkUtf8(lo, _mm256_setzero_si256()), checkUtf8(hi, lo));
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+// Маска байт блока, не являющихся продолжением
+__attribute__((target("avx2")))
+uint64_t avx2LeadMask(const unsigned char* block) {
+    const __m256i lastContinuation = _mm256_set1_epi8(char(0xBF));
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    uint32_t leadLo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(lo, lastContinuation)));
+    uint32_t leadHi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(hi, lastContinuation)));
+    return leadLo | (static_cast<uint64_t>(leadHi) << 32);
+}
+
+bool simdAvailable() {
+    static const bool available = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return available;
+}
+
+#endif // WORDCOUNT_X86_UTF8
+
+} // namespace
+
+Utf8Counter::Utf8Counter(bool lettersOnly) : lettersOnly(lettersOnly) {}
+
+void Utf8Counter::reportInvalid(uint64_t offset) {
+    ++invalid;
+    if (offsets.size() < kMaxReportedOffsets) {
+        offsets.push_back(offset);
+    }
+}
+
+void Utf8Counter::scalar(const unsigned char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char c = data[i];
+        uint64_t offset = processed + i;
+
+        points += !isContinuation(c);
+
+        if (need > 0) {
+            if (c >= lower && c <= upper) {
+                codePoint = (codePoint << 6) | (c & 0x3F);
+                lower = 0x80;
+                upper = 0xBF;
+                if (--need == 0) {
+                    letters += isLetterCodePoint(codePoint);
+                }
+                continue;
+            }
+            // Последовательность оборвана: текущий байт разбираем заново
+            reportInvalid(sequenceStart);
+            need = 0;
+            lower = 0x80;
+            upper = 0xBF;
+        }
+
+        if (c < 0x80) {
+            letters += isLetterCodePoint(c);
+            continue;
+        }
+
+        sequenceStart = offset;
+        if (c >= 0xC2 && c <= 0xDF) {
+            need = 1;
+            codePoint = c & 0x1F;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            need = 2;
+            codePoint = c & 0x0F;
+            if (c == 0xE0) {
+                lower = 0xA0;
+            } else if (c == 0xED) {
+                upper = 0x9F;
+            }
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            need = 3;
+            codePoint = c & 0x07;
+            if (c == 0xF0) {
+                lower = 0x90;
+            } else if (c == 0xF4) {
+                upper = 0x8F;
+            }
+        } else {
+            // Одиночный байт продолжения или недопустимый ведущий байт
+            reportInvalid(offset);
+        }
+    }
+    processed += size;
+}
+
+void Utf8Counter::feed(const unsigned char* data, size_t size) {
+#ifdef WORDCOUNT_X86_UTF8
+    bool useSimd = !lettersOnly && simdAvailable();
+#else
+    bool useSimd = false;
+#endif
+    size_t i = 0;
+
+    while (i < size) {
+        size_t rest = size - i;
+
+#ifdef WORDCOUNT_X86_UTF8
+        if (useSimd && need == 0 && rest >= kBlockSize) {
+            const unsigned char* block = data + i;
+            if (avx2BlockValid(block)) {
+                size_t prefix = completePrefix(block);
+                uint64_t mask = avx2LeadMask(block);
+                if (prefix < kBlockSize) {
+                    mask &= (uint64_t(1) << prefix) - 1;
+                }
+                points += __builtin_popcountll(mask);
+                processed += prefix;
+                i += prefix;
+            } else {
+                scalar(block, kBlockSize);
+                i += kBlockSize;
+            }
+            continue;
+        }
+#endif
+
+        size_t step = useSimd && rest > kBlockSize ? kBlockSize : rest;
+        scalar(data + i, step);
+        i += step;
+    }
+}
+
+void Utf8Counter::merge(const Utf8Counter& next) {
+    if (need > 0 && next.processed > 0) {
+        reportInvalid(sequenceStart);
+        need = 0;
+    }
+
+    points += next.points;
+    letters += next.letters;
+    invalid += next.invalid;
+    for (uint64_t offset : next.offsets) {
+        if (offsets.size() >= kMaxReportedOffsets) {
+            break;
+        }
+        offsets.push_back(processed + offset);
+    }
+
+    if (next.processed > 0) {
+        need = next.need;
+        lower = next.lower;
+        upper = next.upper;
+        codePoint = next.codePoint;
+        sequenceStart = processed + next.sequenceStart;
+    }
+    processed += next.processed;
+}
+
+uint64_t Utf8Counter::invalidCount() const {
+    return invalid + (need > 0);
+}
+
+std::vector<uint64_t> Utf8Counter::invalidOffsets() const {
+    std::vector<uint64_t> result = offsets;
+    if (need > 0 && result.size() < kMaxReportedOffsets) {
+        result.push_back(sequenceStart);
+    }
+    return result;
+}
+
+void Utf8Counter::save(std::ostream& out) const {
+    out << processed << ' ' << points << ' ' << letters << ' ' << invalid << ' '
+        << need << ' ' << static_cast<int>(lower) << ' ' << static_cast<int>(upper) << ' '
+        << codePoint << ' ' << sequenceStart << ' ' << offsets.size();
+    for (uint64_t offset : offsets) {
+        out << ' ' << offset;
+    }
+}
+
+bool Utf8Counter::load(std::istream& in) {
+    int low;
+    int up;
+    size_t count;
+    in >> processed >> points >> letters >> invalid >> need >> low >> up
+       >> codePoint >> sequenceStart >> count;
+    if (!in || count > kMaxReportedOffsets) {
+        return false;
+    }
+    lower = static_cast<unsigned char>(low);
+    upper = static_cast<unsigned char>(up);
+    offsets.resize(count);
+    for (uint64_t& offset : offsets) {
+        in >> offset;
+    }
+    return static_cast<bool>(in);
+}
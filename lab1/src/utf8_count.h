@@ -0,0 +1,59 @@
+#ifndef UTF8_COUNT_H
+#define UTF8_COUNT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// Подсчёт символов Unicode в UTF-8 с проверкой корректности.
+// Символом считается каждый байт, не являющийся продолжением (10xxxxxx),
+// поэтому число символов не зависит от того, как вход разбит на блоки.
+// Буквы (режим lettersOnly) считаются только для корректных
+// последовательностей: латиница, греческий алфавит и кириллица.
+//
+// Корректные блоки по 64 байта проверяются векторно (AVX2, алгоритм
+// Кейзера-Лемира), блоки с ошибками и буквы разбираются скалярным автоматом,
+// который и сообщает смещения некорректных последовательностей
+class Utf8Counter {
+private:
+    static const size_t kMaxReportedOffsets = 16;
+
+    bool lettersOnly;
+    uint64_t processed = 0;
+    uint64_t points = 0;
+    uint64_t letters = 0;
+    uint64_t invalid = 0;
+    std::vector<uint64_t> offsets;
+
+    // Состояние автомата: сколько байт продолжения ещё ждём и в каком диапазоне
+    int need = 0;
+    unsigned char lower = 0x80;
+    unsigned char upper = 0xBF;
+    uint32_t codePoint = 0;
+    uint64_t sequenceStart = 0;
+
+    void scalar(const unsigned char* data, size_t size);
+    void reportInvalid(uint64_t offset);
+
+public:
+    explicit Utf8Counter(bool lettersOnly = false);
+
+    void feed(const unsigned char* data, size_t size);
+
+    // Присоединяет счётчик, обработавший следующий участок данных.
+    // Граница участков не должна разрезать символ
+    void merge(const Utf8Counter& next);
+
+    uint64_t codePoints() const { return points; }
+    uint64_t letterCount() const { return letters; }
+
+    // Некорректные последовательности, включая оборванную в конце данных
+    uint64_t invalidCount() const;
+    std::vector<uint64_t> invalidOffsets() const;
+
+    void save(std::ostream& out) const;
+    bool load(std::istream& in);
+};
+
+#endif // UTF8_COUNT_H
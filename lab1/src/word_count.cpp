@@ -1,42 +1,87 @@
+#include "count_cache.h"
+#include "file_source.h"
+#include "parallel_count.h"
+#include "stopwatch.h"
 #include "word_count.h"
-#include <fstream>
-#include <cctype>
 
-WordCounter::WordCounter(const std::string& filename) : filename(filename) {}
+#include <vector>
+
+namespace {
+
+// Буфер потокового чтения: память не зависит от объёма входа
+const size_t kStreamBufferSize = 256 << 10;
 
-int WordCounter::countLines() const {
-    std::ifstream file(filename);
-    int lines = 0;
-    std::string line;
-    while (std::getline(file, line)) {
-        ++lines;
+CountResult countStream(FileSource& source, const CountOptions& options) {
+    std::vector<char> buffer(kStreamBufferSize);
+    CountEngine engine(options);
+    double ioSeconds = 0;
+    double countSeconds = 0;
+
+    while (true) {
+        double readStart = wallSeconds();
+        size_t got = source.read(buffer.data(), buffer.size());
+        double readEnd = wallSeconds();
+        ioSeconds += readEnd - readStart;
+        if (got == 0) {
+            break;
+        }
+        engine.feed(buffer.data(), got);
+        countSeconds += wallSeconds() - readEnd;
     }
-    return lines;
+
+    CountResult result = engine.result();
+    result.stats.ioSeconds = ioSeconds;
+    result.stats.countSeconds = countSeconds;
+    return result;
 }
 
-int WordCounter::countWords() const {
-    std::ifstream file(filename);
-    int words = 0;
-    std::string word;
-    while (file >> word) {
-        ++words;
+} // namespace
+
+WordCounter::WordCounter(const std::string& filename) : filename(filename) {}
+
+CountResult WordCounter::count(const CountOptions& options) const {
+    // В пуле файл считается одним потоком, иначе могут работать
+    // несколько потоков и учитывается время всего процесса
+    bool singleThread = options.jobs <= 1;
+    double start = wallSeconds();
+    double cpuStart = singleThread ? threadCpuSeconds() : processCpuSeconds();
+
+    CountResult result;
+    if (options.cache != nullptr) {
+        result = options.cache->count(filename, options);
+    } else {
+        FileSource source(filename);
+        if (source.isStream()) {
+            result = countStream(source, options);
+        } else {
+            double opened = wallSeconds();
+            result = countParallel(source.data(), source.size(), options);
+            result.stats.ioSeconds = opened - start;
+            result.stats.countSeconds = wallSeconds() - opened;
+        }
+        if (source.hasError()) {
+            return readErrorResult();
+        }
+        result.stats.bytesRead = result.bytes;
     }
-    return words;
+
+    result.stats.wallSeconds = wallSeconds() - start;
+    result.stats.cpuSeconds = (singleThread ? threadCpuSeconds() : processCpuSeconds()) - cpuStart;
+    return result;
 }
 
-int WordCounter::countBytes() const {
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
-    return file.tellg();
+uint64_t WordCounter::countLines() const {
+    return count().lines;
 }
 
-int WordCounter::countChars() const {
-    std::ifstream file(filename);
-    int chars = 0;
-    char c;
-    while (file.get(c)) {
-        if (std::isalpha(c)) {
-            ++chars;
-        }
-    }
-    return chars;
+uint64_t WordCounter::countWords() const {
+    return count().words;
+}
+
+uint64_t WordCounter::countBytes() const {
+    return count().bytes;
+}
+
+uint64_t WordCounter::countChars() const {
+    return count().chars;
 }
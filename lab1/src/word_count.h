@@ -1,6 +1,9 @@
 #ifndef WORD_COUNT_H
 #define WORD_COUNT_H
 
+#include "count_engine.h"
+
+#include <cstdint>
 #include <string>
 
 class WordCounter {
@@ -10,10 +13,14 @@ private:
 public:
     WordCounter(const std::string& filename);
 
-    int countLines() const;
-    int countWords() const;
-    int countBytes() const;
-    int countChars() const;
+    // Все метрики за один проход по файлу.
+    // При options.jobs > 1 большой файл делится на части и считается в нескольких потоках
+    CountResult count(const CountOptions& options = CountOptions()) const;
+
+    uint64_t countLines() const;
+    uint64_t countWords() const;
+    uint64_t countBytes() const;
+    uint64_t countChars() const;
 };
 
 #endif // WORD_COUNT_H
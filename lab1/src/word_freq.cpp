@@ -0,0 +1,248 @@
+#include "count_kernels.h"
+#include "word_freq.h"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <string_view>
+
+namespace {
+
+const size_t kInitialTableSize = 1 << 12;
+
+uint64_t hashBytes(const char* data, size_t length) {
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+    uint64_t hash = length * multiplier;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 29;
+    }
+    uint64_t rest = 0;
+    std::memcpy(&rest, data + i, length - i);
+    hash = (hash ^ rest) * multiplier;
+    return hash ^ (hash >> 32);
+}
+
+} // namespace
+
+const char* WordFrequency::keyData(const Slot& slot) const {
+    return arena[slot.block].data() + slot.offset;
+}
+
+const char* WordFrequency::intern(const char* word, size_t length,
+                                  uint32_t& block, uint32_t& offset) {
+    if (arena.empty() || arena.back().capacity() - arena.back().size() < length) {
+        arena.emplace_back();
+        arena.back().reserve(length > kArenaBlockSize ? length : kArenaBlockSize);
+    }
+    std::vector<char>& current = arena.back();
+    block = static_cast<uint32_t>(arena.size() - 1);
+    offset = static_cast<uint32_t>(current.size());
+    // Вместимость зарезервирована заранее, поэтому блок не перемещается
+    current.insert(current.end(), word, word + length);
+    return current.data() + offset;
+}
+
+void WordFrequency::grow() {
+    std::vector<Slot> old;
+    old.swap(table);
+    table.assign(old.empty() ? kInitialTableSize : old.size() * 2, Slot());
+    size_t mask = table.size() - 1;
+
+    for (const Slot& slot : old) {
+        if (slot.count == 0) {
+            continue;
+        }
+        size_t pos = slot.hash & mask;
+        while (table[pos].count != 0) {
+            pos = (pos + 1) & mask;
+        }
+        table[pos] = slot;
+    }
+}
+
+void WordFrequency::add(const char* word, size_t length, uint64_t count) {
+    // Заполненность не выше 70%
+    if ((used + 1) * 10 > table.size() * 7) {
+        grow();
+    }
+
+    uint64_t hash = hashBytes(word, length);
+    size_t mask = table.size() - 1;
+    size_t pos = hash & mask;
+
+    while (table[pos].count != 0) {
+        Slot& slot = table[pos];
+        if (slot.hash == hash && slot.length == length
+            && std::memcmp(keyData(slot), word, length) == 0) {
+            slot.count += count;
+            return;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    Slot& slot = table[pos];
+    intern(word, length, slot.block, slot.offset);
+    slot.hash = hash;
+    slot.length = static_cast<uint32_t>(length);
+    slot.count = count;
+    ++used;
+}
+
+void WordFrequency::feed(const char* data, size_t size) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    size_t i = 0;
+
+    if (!sawSpace) {
+        while (i < size && !isAsciiSpace(p[i])) {
+            ++i;
+        }
+        head.append(data, i);
+        if (i == size) {
+            return;
+        }
+        sawSpace = true;
+    }
+
+    // Слово, начатое в предыдущей порции
+    if (!tail.empty()) {
+        size_t end = i;
+        while (end < size && !isAsciiSpace(p[end])) {
+            ++end;
+        }
+        tail.append(data + i, end - i);
+        if (end == size) {
+            return;
+        }
+        add(tail.data(), tail.size(), 1);
+        tail.clear();
+        i = end;
+    }
+
+    while (i < size) {
+        while (i < size && isAsciiSpace(p[i])) {
+            ++i;
+        }
+        size_t start = i;
+        while (i < size && !isAsciiSpace(p[i])) {
+            ++i;
+        }
+        if (i == size) {
+            tail.assign(data + start, i - start);
+        } else {
+            add(data + start, i - start, 1);
+        }
+    }
+}
+
+void WordFrequency::merge(const WordFrequency& next) {
+    for (const Slot& slot : next.table) {
+        if (slot.count != 0) {
+            add(next.keyData(slot), slot.length, slot.count);
+        }
+    }
+
+    if (!sawSpace) {
+        head += next.head;
+        if (next.sawSpace) {
+            sawSpace = true;
+            tail = next.tail;
+        }
+        return;
+    }
+
+    tail += next.head;
+    if (next.sawSpace) {
+        if (!tail.empty()) {
+            add(tail.data(), tail.size(), 1);
+        }
+        tail = next.tail;
+    }
+}
+
+const WordFrequency::Slot* WordFrequency::find(const char* word, size_t length) const {
+    if (table.empty()) {
+        return nullptr;
+    }
+    uint64_t hash = hashBytes(word, length);
+    size_t mask = table.size() - 1;
+    for (size_t pos = hash & mask; table[pos].count != 0; pos = (pos + 1) & mask) {
+        const Slot& slot = table[pos];
+        if (slot.hash == hash && slot.length == length
+            && std::memcmp(keyData(slot), word, length) == 0) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::pair<std::string, uint64_t>> WordFrequency::top(size_t k) const {
+    using Candidate = std::pair<uint64_t, std::string_view>;
+
+    std::vector<std::pair<std::string, uint64_t>> result;
+    if (k == 0) {
+        return result;
+    }
+
+    // Незавершённые слова на краях тоже являются словами. Таблица не
+    // копируется: слово с края либо добавляет единицу к своей записи,
+    // либо становится отдельным кандидатом
+    std::string_view edges[2];
+    size_t edgeCount = 0;
+    if (!head.empty()) {
+        edges[edgeCount++] = head;
+    }
+    if (sawSpace && !tail.empty()) {
+        edges[edgeCount++] = tail;
+    }
+    const Slot* edgeSlots[2] = {nullptr, nullptr};
+    for (size_t i = 0; i < edgeCount; ++i) {
+        edgeSlots[i] = find(edges[i].data(), edges[i].size());
+    }
+
+    // Частичная куча: на вершине худший из k лучших. Ключи — ссылки
+    // в арену, строки создаются только для попавших в ответ
+    auto better = [](const Candidate& a, const Candidate& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(better)> heap(better);
+    auto offer = [&](const Candidate& candidate) {
+        if (heap.size() < k) {
+            heap.push(candidate);
+        } else if (better(candidate, heap.top())) {
+            heap.pop();
+            heap.push(candidate);
+        }
+    };
+
+    for (const Slot& slot : table) {
+        if (slot.count == 0) {
+            continue;
+        }
+        uint64_t count = slot.count;
+        for (size_t i = 0; i < edgeCount; ++i) {
+            count += edgeSlots[i] == &slot;
+        }
+        offer(Candidate(count, std::string_view(keyData(slot), slot.length)));
+    }
+
+    // Края, которых нет в таблице; одинаковые края — одно слово дважды
+    if (edgeCount > 0 && edgeSlots[0] == nullptr) {
+        bool same = edgeCount == 2 && edges[0] == edges[1];
+        offer(Candidate(same ? 2 : 1, edges[0]));
+    }
+    if (edgeCount == 2 && edgeSlots[1] == nullptr && edges[0] != edges[1]) {
+        offer(Candidate(1, edges[1]));
+    }
+
+    result.reserve(heap.size());
+    while (!heap.empty()) {
+        result.emplace_back(std::string(heap.top().second), heap.top().first);
+        heap.pop();
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
@@ -0,0 +1,52 @@
+#ifndef WORD_FREQ_H
+#define WORD_FREQ_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Частоты слов (непробельных последовательностей байт, как у счётчика слов).
+// Ключи хранятся в арене из больших блоков, таблица — открытая адресация
+// с линейным пробированием. Ключ адресуется номером блока и смещением,
+// поэтому объект можно копировать.
+//
+// Данные можно подавать порциями и сливать счётчики соседних участков:
+// незавершённые слова на краях хранятся отдельно и склеиваются при merge
+class WordFrequency {
+private:
+    struct Slot {
+        uint64_t hash = 0;
+        uint64_t count = 0;
+        uint32_t block = 0;
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    static const size_t kArenaBlockSize = 1 << 20;
+
+    std::vector<std::vector<char>> arena;
+    std::vector<Slot> table;
+    size_t used = 0;
+
+    // Начало данных до первого пробела и незавершённое слово после последнего
+    std::string head;
+    std::string tail;
+    bool sawSpace = false;
+
+    const char* keyData(const Slot& slot) const;
+    const char* intern(const char* word, size_t length, uint32_t& block, uint32_t& offset);
+    void grow();
+    void add(const char* word, size_t length, uint64_t count);
+    const Slot* find(const char* word, size_t length) const;
+
+public:
+    void feed(const char* data, size_t size);
+    void merge(const WordFrequency& next);
+
+    // k самых частых слов (по убыванию частоты, при равенстве — по алфавиту)
+    std::vector<std::pair<std::string, uint64_t>> top(size_t k) const;
+};
+
+#endif // WORD_FREQ_H
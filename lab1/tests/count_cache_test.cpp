@@ -0,0 +1,153 @@
+#include "count_cache.h"
+#include "word_count.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+class CountCacheTests : public testing::Test {
+protected:
+    std::string file;
+    std::string store;
+
+    void SetUp() override {
+        std::filesystem::path dir = std::filesystem::temp_directory_path();
+        file = (dir / "word_count_cache_input.txt").string();
+        store = (dir / "word_count_cache_store.txt").string();
+        std::remove(file.c_str());
+        std::remove(store.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(file.c_str());
+        std::remove(store.c_str());
+    }
+
+    void write(const std::string& content, std::ios::openmode mode = std::ios::trunc) {
+        std::ofstream out(file, std::ios::binary | mode);
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+    }
+
+    // Время изменения сдвигается явно: в пределах секунды оно может не смениться
+    void touch(int seconds) {
+        auto time = std::filesystem::last_write_time(file);
+        std::filesystem::last_write_time(file, time + std::chrono::seconds(seconds));
+    }
+
+    // Подсчёт через хранилище, загруженное с диска и сохранённое после подсчёта
+    CountResult cached(CharMode mode = CharMode::AsciiLetters) {
+        CountCache cache(store);
+        CountOptions options;
+        options.charMode = mode;
+        options.cache = &cache;
+        CountResult result = cache.count(file, options);
+        EXPECT_TRUE(cache.save());
+        return result;
+    }
+
+    CountResult fresh(CharMode mode = CharMode::AsciiLetters) {
+        CountOptions options;
+        options.charMode = mode;
+        return WordCounter(file).count(options);
+    }
+};
+
+void expectSameCounts(const CountResult& expected, const CountResult& actual) {
+    EXPECT_EQ(expected.lines, actual.lines);
+    EXPECT_EQ(expected.words, actual.words);
+    EXPECT_EQ(expected.bytes, actual.bytes);
+    EXPECT_EQ(expected.chars, actual.chars);
+    EXPECT_EQ(expected.invalidUtf8, actual.invalidUtf8);
+}
+
+// Текст больше отпечатка (4 КБ), чтобы дочитывание было заметно по bytesRead
+std::string longText() {
+    std::string text;
+    while (text.size() < 64 << 10) {
+        text += "alpha beta\ngamma  delta ";
+    }
+    return text;
+}
+
+} // namespace
+
+TEST_F(CountCacheTests, UnchangedFileTest) {
+    write(longText());
+    CountResult first = cached();
+    expectSameCounts(fresh(), first);
+    EXPECT_EQ(first.stats.bytesRead, first.bytes);
+
+    // Размер и время те же: файл не читается вовсе
+    CountResult second = cached();
+    expectSameCounts(first, second);
+    EXPECT_EQ(second.stats.bytesRead, 0u);
+}
+
+TEST_F(CountCacheTests, AppendSplitsWordTest) {
+    write(longText() + "hello wor");
+    cached();
+
+    // Дописанный хвост продолжает незавершённое слово
+    write("ld again\nend", std::ios::app);
+    touch(2);
+    CountResult appended = cached();
+    expectSameCounts(fresh(), appended);
+    // Прочитаны только отпечаток начала и новый хвост
+    EXPECT_EQ(appended.stats.bytesRead, 4096u + 12);
+}
+
+TEST_F(CountCacheTests, AppendSplitsUtf8CharacterTest) {
+    write(longText() + "при\xd0");
+    cached(CharMode::Letters);
+
+    write("\xb2\xd0\xb5\xd1\x82 мир", std::ios::app);
+    touch(2);
+    expectSameCounts(fresh(CharMode::Letters), cached(CharMode::Letters));
+}
+
+TEST_F(CountCacheTests, RewrittenHeadSameSizeTest) {
+    std::string text = longText();
+    write(text);
+    cached();
+
+    // Начало переписано, размер прежний: отпечаток не совпадает, полный подсчёт
+    text.replace(0, 11, "x y z w v u");
+    write(text);
+    touch(2);
+    CountResult rewritten = cached();
+    expectSameCounts(fresh(), rewritten);
+    EXPECT_EQ(rewritten.stats.bytesRead, text.size());
+}
+
+TEST_F(CountCacheTests, SmallerFileTest) {
+    write(longText());
+    cached();
+
+    write("short file\n");
+    touch(2);
+    CountResult truncated = cached();
+    expectSameCounts(fresh(), truncated);
+    EXPECT_EQ(truncated.words, 2u);
+}
+
+TEST_F(CountCacheTests, CharModeMismatchTest) {
+    write(longText() + "ёжик в тумане");
+    cached(CharMode::AsciiLetters);
+
+    // Точка сохранена в другом режиме символов: она не подходит, и даже
+    // неизменный файл считается заново
+    CountResult letters = cached(CharMode::Letters);
+    expectSameCounts(fresh(CharMode::Letters), letters);
+    EXPECT_EQ(letters.stats.bytesRead, letters.bytes);
+
+    // Новая точка — уже для букв Unicode
+    CountResult again = cached(CharMode::Letters);
+    expectSameCounts(letters, again);
+    EXPECT_EQ(again.stats.bytesRead, 0u);
+}
@@ -0,0 +1,113 @@
+#include "count_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+void expectSameState(const KernelState& expected, const KernelState& actual, const std::string& label) {
+    EXPECT_EQ(expected.newlines, actual.newlines) << label;
+    EXPECT_EQ(expected.words, actual.words) << label;
+    EXPECT_EQ(expected.chars, actual.chars) << label;
+    EXPECT_EQ(expected.inWord, actual.inWord) << label;
+    EXPECT_EQ(expected.lineLength, actual.lineLength) << label;
+    EXPECT_EQ(expected.lines.count, actual.lines.count) << label;
+    EXPECT_EQ(expected.lines.longest, actual.lines.longest) << label;
+    EXPECT_EQ(expected.lines.first, actual.lines.first) << label;
+    for (int i = 0; i < LineStats::kBuckets; ++i) {
+        EXPECT_EQ(expected.lines.histogram[i], actual.lines.histogram[i]) << label << ", bucket " << i;
+    }
+}
+
+// Каждое векторное ядро (и его вариант с длинами строк) на data[begin, end)
+// должно дать то же состояние, что и скалярное, при обоих начальных inWord
+void expectKernelsMatchScalar(const std::vector<unsigned char>& data, size_t begin, size_t end,
+                              const std::string& label) {
+    std::vector<CountKernelInfo> kernels = availableCountKernels();
+    ASSERT_STREQ(kernels.front().name, "scalar");
+
+    for (bool inWord : {false, true}) {
+        KernelState initial;
+        initial.inWord = inWord;
+        initial.lineLength = 7;
+
+        KernelState expected = initial;
+        kernels.front().kernel(data.data() + begin, end - begin, expected);
+        KernelState expectedLines = initial;
+        kernels.front().lineKernel(data.data() + begin, end - begin, expectedLines);
+
+        for (size_t k = 1; k < kernels.size(); ++k) {
+            std::string name = label + ", " + kernels[k].name + ", inWord " + std::to_string(inWord);
+            KernelState actual = initial;
+            kernels[k].kernel(data.data() + begin, end - begin, actual);
+            expectSameState(expected, actual, name);
+
+            KernelState actualLines = initial;
+            kernels[k].lineKernel(data.data() + begin, end - begin, actualLines);
+            expectSameState(expectedLines, actualLines, name + ", lines");
+        }
+    }
+}
+
+} // namespace
+
+TEST(CountKernelsTests, RandomBytesTest) {
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    // Длины вокруг границ 16-, 32- и 64-байтных блоков и невыровненные начала
+    for (size_t size = 0; size <= 300; ++size) {
+        std::vector<unsigned char> data(size + 3);
+        for (unsigned char& c : data) {
+            c = static_cast<unsigned char>(byte(rng));
+        }
+        for (size_t begin = 0; begin <= 3; ++begin) {
+            expectKernelsMatchScalar(data, begin, begin + size,
+                                     "size " + std::to_string(size) + ", offset " + std::to_string(begin));
+        }
+    }
+}
+
+TEST(CountKernelsTests, TextLikeBytesTest) {
+    // Слова и пробелы разной длины: переходы между словами попадают
+    // на все позиции внутри блока
+    const std::string alphabet = "ab \n\t\r\v\fZ\x7f\x80\xd0\xb0\xff";
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+
+    for (int iteration = 0; iteration < 200; ++iteration) {
+        std::vector<unsigned char> data(1 + iteration * 7);
+        for (unsigned char& c : data) {
+            c = static_cast<unsigned char>(alphabet[pick(rng)]);
+        }
+        expectKernelsMatchScalar(data, 0, data.size(), "iteration " + std::to_string(iteration));
+    }
+}
+
+TEST(CountKernelsTests, BoundaryBytesTest) {
+    // Каждый байт по отдельности и в блоке из одинаковых байтов
+    // (границы классов: '\t' - 1, '\r' + 1, ' ', 'A' - 1, 'Z' + 1, 0x80 и т. д.)
+    for (int value = 0; value < 256; ++value) {
+        unsigned char c = static_cast<unsigned char>(value);
+        expectKernelsMatchScalar(std::vector<unsigned char>(1, c), 0, 1, "byte " + std::to_string(value));
+        expectKernelsMatchScalar(std::vector<unsigned char>(200, c), 0, 200, "run of " + std::to_string(value));
+    }
+
+    // Все байты подряд
+    std::vector<unsigned char> all(256);
+    for (int value = 0; value < 256; ++value) {
+        all[value] = static_cast<unsigned char>(value);
+    }
+    expectKernelsMatchScalar(all, 0, all.size(), "all bytes");
+
+    // Слово, разрезанное концом блока, и строка длиннее блока
+    std::vector<unsigned char> words(64 * 5, 'x');
+    for (size_t i = 63; i < words.size(); i += 64) {
+        words[i] = ' ';
+    }
+    words[100] = '\n';
+    expectKernelsMatchScalar(words, 0, words.size(), "block boundaries");
+}
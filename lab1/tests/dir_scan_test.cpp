@@ -0,0 +1,132 @@
+#include "dir_scan.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST(MatchGlobTests, StarBacktrackingTest) {
+    EXPECT_TRUE(matchGlob("*", ""));
+    EXPECT_TRUE(matchGlob("*.txt", "notes.txt"));
+    EXPECT_FALSE(matchGlob("*.txt", "notes.txt.bak"));
+    // Первое совпадение ".t" — ложное, звёздочка должна захватить больше
+    EXPECT_TRUE(matchGlob("*.txt", "a.tar.txt"));
+    EXPECT_TRUE(matchGlob("a*b*c", "aXbYbZc"));
+    EXPECT_FALSE(matchGlob("a*b*c", "aXbYbZ"));
+    EXPECT_TRUE(matchGlob("**a", "bba"));
+    EXPECT_TRUE(matchGlob("a*", "a"));
+}
+
+TEST(MatchGlobTests, QuestionMarkTest) {
+    EXPECT_TRUE(matchGlob("?.c", "a.c"));
+    EXPECT_FALSE(matchGlob("?.c", ".c"));
+    EXPECT_FALSE(matchGlob("?.c", "ab.c"));
+    EXPECT_TRUE(matchGlob("*?", "x"));
+    EXPECT_FALSE(matchGlob("*?", ""));
+}
+
+TEST(MatchGlobTests, ClassRangeTest) {
+    EXPECT_TRUE(matchGlob("[a-z]1", "q1"));
+    EXPECT_FALSE(matchGlob("[a-z]1", "Q1"));
+    EXPECT_TRUE(matchGlob("[abc]", "b"));
+    EXPECT_FALSE(matchGlob("[abc]", "d"));
+    EXPECT_TRUE(matchGlob("[0-9a-f]x", "ex"));
+    // '-' в конце класса — обычный символ
+    EXPECT_TRUE(matchGlob("[a-]", "-"));
+    EXPECT_FALSE(matchGlob("*[0-9].log", "app.log"));
+    EXPECT_TRUE(matchGlob("*[0-9].log", "app7.log"));
+}
+
+TEST(MatchGlobTests, NegatedClassTest) {
+    EXPECT_TRUE(matchGlob("[!x]y", "ay"));
+    EXPECT_FALSE(matchGlob("[!x]y", "xy"));
+    EXPECT_TRUE(matchGlob("[^x]y", "ay"));
+    EXPECT_FALSE(matchGlob("[^x]y", "xy"));
+    EXPECT_FALSE(matchGlob("[!a-c]", "b"));
+    EXPECT_TRUE(matchGlob("[!a-c]", "d"));
+}
+
+TEST(MatchGlobTests, BracketAsFirstMemberTest) {
+    EXPECT_TRUE(matchGlob("[]a]", "]"));
+    EXPECT_TRUE(matchGlob("[]a]", "a"));
+    EXPECT_FALSE(matchGlob("[]a]", "b"));
+    EXPECT_FALSE(matchGlob("[!]]", "]"));
+    EXPECT_TRUE(matchGlob("[!]]", "x"));
+}
+
+TEST(MatchGlobTests, UnclosedBracketIsLiteralTest) {
+    EXPECT_TRUE(matchGlob("[abc", "[abc"));
+    EXPECT_FALSE(matchGlob("[abc", "a"));
+    EXPECT_TRUE(matchGlob("x[*", "x[yz"));
+    EXPECT_FALSE(matchGlob("x[*", "xyz"));
+}
+
+TEST(ScanDirectoryTests, OrderWithManyWorkersTest) {
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / "word_count_scan_test";
+    fs::remove_all(root);
+
+    // Файл i содержит i + 1 слово: суммы по каталогам проверяемы
+    std::vector<std::string> expectedOrder;
+    std::map<std::string, uint64_t> expectedWords;
+    int next = 0;
+    auto addFile = [&](const fs::path& path) {
+        fs::create_directories(path.parent_path());
+        std::ofstream out(path);
+        int words = ++next;
+        for (int w = 0; w < words; ++w) {
+            out << "w ";
+        }
+        for (fs::path dir = path.parent_path(); ; dir = dir.parent_path()) {
+            expectedWords[dir.string()] += static_cast<uint64_t>(words);
+            if (dir == root) {
+                break;
+            }
+        }
+    };
+
+    // Порядок обнаружения: файлы каталога по имени, затем подкаталоги по имени
+    for (const char* name : {"a.txt", "b.txt", "c.txt"}) {
+        addFile(root / name);
+        expectedOrder.push_back((root / name).string());
+    }
+    for (const char* sub : {"d1", "d2"}) {
+        for (int i = 0; i < 20; ++i) {
+            std::string name = "f" + std::to_string(10 + i) + ".txt";
+            addFile(root / sub / name);
+            expectedOrder.push_back((root / sub / name).string());
+        }
+        addFile(root / sub / "nested" / "z.txt");
+        expectedOrder.push_back((root / sub / "nested" / "z.txt").string());
+    }
+
+    CountOptions options;
+    options.jobs = 8;
+    std::vector<std::string> order;
+    std::vector<uint64_t> words;
+    auto directories = scanDirectory(root.string(), ScanFilter(), options,
+                                     [&](const std::string& path, const CountResult& result) {
+                                         order.push_back(path);
+                                         words.push_back(result.words);
+                                     });
+
+    EXPECT_EQ(order, expectedOrder);
+    for (size_t i = 0; i < words.size(); ++i) {
+        EXPECT_EQ(words[i], i + 1) << order[i];
+    }
+
+    // Суммы по каталогам: каждый каталог один раз, по возрастанию пути
+    std::vector<std::pair<std::string, uint64_t>> totals;
+    for (const auto& dir : directories) {
+        totals.emplace_back(dir.first, dir.second.words);
+    }
+    std::vector<std::pair<std::string, uint64_t>> expectedTotals(expectedWords.begin(), expectedWords.end());
+    EXPECT_EQ(totals, expectedTotals);
+
+    fs::remove_all(root);
+}
@@ -0,0 +1,151 @@
+#include "estimate.h"
+#include "word_count.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+const size_t kBlock = 64 << 10;
+
+std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("word_count_estimate_" + name)).string();
+}
+
+void writeFile(const std::string& path, const std::string& content) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+// Блоки по 64 КБ из одинаковых периодов по 16 байт: блок начинается
+// с пробела и кончается буквой, поэтому вклады всех блоков (и первого)
+// равны, и оценка по любой выборке точна
+std::string uniformBlocks(size_t blocks) {
+    const std::string period = " abc def\nghij kl";
+    std::string text;
+    text.reserve(blocks * kBlock);
+    while (text.size() < blocks * kBlock) {
+        text += period;
+    }
+    return text;
+}
+
+void expectExactMatch(const EstimateResult& estimate, const CountResult& truth) {
+    EXPECT_EQ(estimate.lines.value, static_cast<double>(truth.lines));
+    EXPECT_EQ(estimate.words.value, static_cast<double>(truth.words));
+    EXPECT_EQ(estimate.chars.value, static_cast<double>(truth.chars));
+    EXPECT_EQ(estimate.bytes, truth.bytes);
+}
+
+} // namespace
+
+TEST(EstimateTests, SmallFileIsExactTest) {
+    std::string path = tempPath("small");
+    writeFile(path, uniformBlocks(127) + "tail without newline");
+
+    EstimateResult estimate = estimateFile(path, CountOptions(), 0.01);
+    EXPECT_TRUE(estimate.exact);
+    EXPECT_EQ(estimate.sampledBytes, estimate.bytes);
+    expectExactMatch(estimate, WordCounter(path).count());
+    std::remove(path.c_str());
+}
+
+// Выборочное чтение есть только в POSIX-версии
+#ifndef _WIN32
+
+TEST(EstimateTests, NonRegularInputIsExactTest) {
+    EstimateResult empty = estimateFile("/dev/null", CountOptions(), 0.01);
+    EXPECT_TRUE(empty.exact);
+    EXPECT_EQ(empty.bytes, 0u);
+
+    // Канал нельзя читать выборочно: он вычитывается целиком
+    std::string path = tempPath("fifo");
+    std::remove(path.c_str());
+    ASSERT_EQ(mkfifo(path.c_str(), 0600), 0);
+    std::thread writer([&]() {
+        std::ofstream out(path, std::ios::binary);
+        out << "one two\nthree\n";
+    });
+    EstimateResult piped = estimateFile(path, CountOptions(), 0.01);
+    writer.join();
+    EXPECT_TRUE(piped.exact);
+    EXPECT_EQ(piped.lines.value, 2);
+    EXPECT_EQ(piped.words.value, 3);
+    EXPECT_EQ(piped.bytes, 14u);
+    std::remove(path.c_str());
+}
+
+TEST(EstimateTests, TailAndLastByteTest) {
+    // Хвост продолжает слово последнего полного блока ("kl" + "mn")
+    // и кончается без '\n': строка должна добавиться, слово — нет
+    std::string path = tempPath("tail");
+    writeFile(path, uniformBlocks(160) + "mn op\nqr st");
+
+    EstimateResult estimate = estimateFile(path, CountOptions(), 0.01);
+    EXPECT_FALSE(estimate.exact);
+    EXPECT_LT(estimate.sampledBytes, estimate.bytes);
+    EXPECT_EQ(estimate.lines.stdError, 0);
+    expectExactMatch(estimate, WordCounter(path).count());
+
+    // Без хвоста: последний байт блока — буква, строка без '\n' тоже считается
+    writeFile(path, uniformBlocks(160));
+    estimate = estimateFile(path, CountOptions(), 0.01);
+    EXPECT_FALSE(estimate.exact);
+    expectExactMatch(estimate, WordCounter(path).count());
+    std::remove(path.c_str());
+}
+
+TEST(EstimateTests, IntervalCoversTruthTest) {
+    // Случайный текст из 200 блоков: слова и строки случайной длины
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> wordLength(1, 12);
+    std::uniform_int_distribution<int> wordsPerLine(0, 15);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::string text;
+    while (text.size() < 200 * kBlock + 1000) {
+        for (int w = wordsPerLine(rng); w > 0; --w) {
+            for (int k = wordLength(rng); k > 0; --k) {
+                text += static_cast<char>(letter(rng));
+            }
+            text += w > 1 ? ' ' : '\n';
+        }
+        text += '\n';
+    }
+    std::string path = tempPath("random");
+    writeFile(path, text);
+    CountResult truth = WordCounter(path).count();
+
+    // Интервал 95% должен накрывать истину примерно в 95% запусков;
+    // меньше 16 из 20 при верном интервале случается реже чем в 0.3% случаев
+    const int kRuns = 20;
+    int covered[3] = {};
+    for (int run = 0; run < kRuns; ++run) {
+        EstimateResult estimate = estimateFile(path, CountOptions(), 0.005);
+        ASSERT_FALSE(estimate.exact);
+        const EstimatedValue* values[3] = {&estimate.lines, &estimate.words, &estimate.chars};
+        const double truths[3] = {static_cast<double>(truth.lines), static_cast<double>(truth.words),
+                                  static_cast<double>(truth.chars)};
+        for (int m = 0; m < 3; ++m) {
+            if (std::fabs(values[m]->value - truths[m]) <= kConfidenceZ * values[m]->stdError) {
+                ++covered[m];
+            }
+        }
+    }
+    EXPECT_GE(covered[0], 16) << "lines";
+    EXPECT_GE(covered[1], 16) << "words";
+    EXPECT_GE(covered[2], 16) << "chars";
+    std::remove(path.c_str());
+}
+
+#endif // _WIN32
@@ -0,0 +1,83 @@
+#include "parallel_count.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <tuple>
+
+namespace {
+
+CountResult countSequential(const std::string& text, const CountOptions& options) {
+    CountEngine engine(options);
+    engine.feed(text.data(), text.size());
+    return engine.result();
+}
+
+void expectSameResult(const CountResult& expected, const CountResult& actual, const std::string& label) {
+    EXPECT_EQ(expected.lines, actual.lines) << label;
+    EXPECT_EQ(expected.words, actual.words) << label;
+    EXPECT_EQ(expected.bytes, actual.bytes) << label;
+    EXPECT_EQ(expected.chars, actual.chars) << label;
+    EXPECT_EQ(expected.invalidUtf8, actual.invalidUtf8) << label;
+    EXPECT_EQ(expected.invalidUtf8Offsets, actual.invalidUtf8Offsets) << label;
+    EXPECT_EQ(expected.topWords, actual.topWords) << label;
+    EXPECT_EQ(expected.longestLine, actual.longestLine) << label;
+    EXPECT_EQ(expected.lineLengthSum, actual.lineLengthSum) << label;
+    EXPECT_EQ(expected.lineHistogram, actual.lineHistogram) << label;
+}
+
+// Длинные слова, серии пробелов и переводов строк, двух-, трёх-
+// и четырёхбайтные символы UTF-8 и одна некорректная последовательность
+const std::string kText =
+    "Lorem  ipsum\tdolor\n\n\nsit    amet, consectetur\r\n"
+    "Привет,   мир!  Ελληνικά\tγράμματα  \n"
+    "日本語のテキスト 😀😀 emoji\xe2\x82 broken\n"
+    "supercalifragilisticexpialidocious          \v\f end";
+
+} // namespace
+
+class ParallelCountTestsSuite : public testing::TestWithParam<std::tuple<CharMode, unsigned>> {
+};
+
+TEST_P(ParallelCountTestsSuite, MatchesSequentialTest) {
+    CountOptions options;
+    options.charMode = std::get<0>(GetParam());
+    options.jobs = std::get<1>(GetParam());
+    options.topWords = 5;
+    options.lineStats = true;
+
+    // При минимальном размере части в один байт части делятся поровну,
+    // и с каждой длиной префикса границы сдвигаются: они попадают внутрь
+    // слов, в серии пробелов и внутрь многобайтных символов
+    for (size_t size = 0; size <= kText.size(); ++size) {
+        std::string text = kText.substr(0, size);
+        CountResult expected = countSequential(text, options);
+        CountResult actual = countChunks(text.data(), text.size(), options, 1).result();
+        expectSameResult(expected, actual, "prefix " + std::to_string(size));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Group,
+    ParallelCountTestsSuite,
+    testing::Combine(
+        testing::Values(CharMode::AsciiLetters, CharMode::CodePoints, CharMode::Letters),
+        testing::Values(2u, 3u, 5u, 8u, 16u)
+    )
+);
+
+TEST(ParallelCountTests, CutInsideEveryPositionTest) {
+    // Две части: граница проходит через каждую позицию текста
+    CountOptions options;
+    options.charMode = CharMode::Letters;
+    options.jobs = 2;
+    options.lineStats = true;
+
+    std::string doubled = kText + kText;
+    for (size_t cut = 1; cut < kText.size(); ++cut) {
+        std::string text = doubled.substr(0, 2 * cut);
+        expectSameResult(countSequential(text, options),
+                         countChunks(text.data(), text.size(), options, 1).result(),
+                         "cut at " + std::to_string(cut));
+    }
+}
@@ -0,0 +1,98 @@
+#include "report.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+// Выводит записи через ReportWriter во временный файл и возвращает текст
+template <typename Writer>
+std::string render(OutputFormat format, const ReportFields& fields, Writer writeRows) {
+    std::FILE* out = std::tmpfile();
+    {
+        ReportWriter report(format, fields, out);
+        writeRows(report);
+    }
+    std::string text;
+    std::rewind(out);
+    char chunk[4096];
+    size_t got;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), out)) > 0) {
+        text.append(chunk, got);
+    }
+    std::fclose(out);
+    return text;
+}
+
+std::string jsonName(const std::string& name) {
+    ReportFields fields;
+    std::string text = render(OutputFormat::Json, fields, [&](ReportWriter& report) {
+        report.write("file", name, CountResult());
+    });
+    size_t begin = text.find("\"name\": ") + 8;
+    size_t end = text.find('}', begin);
+    return text.substr(begin, end - begin);
+}
+
+} // namespace
+
+TEST(ReportTests, JsonEscapesControlBytesTest) {
+    EXPECT_EQ(jsonName("a\"b\\c"), "\"a\\\"b\\\\c\"");
+    EXPECT_EQ(jsonName(std::string("\x01\t\n\x1f", 4)), "\"\\u0001\\u0009\\u000a\\u001f\"");
+    EXPECT_EQ(jsonName(std::string("\0x", 2)), "\"\\u0000x\"");
+}
+
+TEST(ReportTests, JsonKeepsValidUtf8Test) {
+    EXPECT_EQ(jsonName("é日😀"), "\"é日😀\"");
+    EXPECT_EQ(jsonName("\x7f"), "\"\x7f\"");
+}
+
+TEST(ReportTests, JsonReplacesInvalidUtf8Test) {
+    // Одиночные байты продолжения и недопустимые начальные байты
+    EXPECT_EQ(jsonName("\x80"), "\"\\ufffd\"");
+    EXPECT_EQ(jsonName("a\xff" "b"), "\"a\\ufffdb\"");
+    EXPECT_EQ(jsonName("\xc0\xaf"), "\"\\ufffd\\ufffd\"");
+    // Оборванная последовательность: каждый байт заменяется отдельно
+    EXPECT_EQ(jsonName("\xe2\x82"), "\"\\ufffd\\ufffd\"");
+    EXPECT_EQ(jsonName("\xe2\x82x"), "\"\\ufffd\\ufffdx\"");
+    // Overlong-форма, суррогат и символ за U+10FFFF
+    EXPECT_EQ(jsonName("\xe0\x80\x80"), "\"\\ufffd\\ufffd\\ufffd\"");
+    EXPECT_EQ(jsonName("\xed\xa0\x80"), "\"\\ufffd\\ufffd\\ufffd\"");
+    EXPECT_EQ(jsonName("\xf4\x90\x80\x80"), "\"\\ufffd\\ufffd\\ufffd\\ufffd\"");
+}
+
+TEST(ReportTests, TsvTopWordsColumnTest) {
+    ReportFields fields;
+    fields.words = true;
+    CountResult result;
+    result.words = 3;
+    result.topWords = {{"a", 2}, {"b", 1}};
+
+    std::string plain = render(OutputFormat::Tsv, fields, [&](ReportWriter& report) {
+        report.write("file", "f", result);
+    });
+    EXPECT_EQ(plain, "kind\tname\twords\nfile\tf\t3\n");
+
+    fields.topWords = true;
+    std::string withTop = render(OutputFormat::Tsv, fields, [&](ReportWriter& report) {
+        report.write("file", "f", result);
+    });
+    EXPECT_EQ(withTop, "kind\tname\twords\ttop_words\nfile\tf\t3\t2:a 1:b\n");
+}
+
+TEST(ReportTests, TsvDirectoryHasNoStatsTest) {
+    ReportFields fields;
+    fields.lines = true;
+    fields.stats = true;
+    CountResult result;
+    result.lines = 1;
+    result.stats.bytesRead = 5;
+
+    std::string text = render(OutputFormat::Tsv, fields, [&](ReportWriter& report) {
+        report.write("directory", "d", result);
+    });
+    EXPECT_EQ(text, "kind\tname\tlines\tbytes_read\twall_s\tcpu_s\tio_s\tcount_s\tgb_per_s\n"
+                    "directory\td\t1\t\t\t\t\t\t\n");
+}
@@ -1,4 +1,5 @@
 #include <lib/number.h>
+
 #include <iostream>
 
 int main() {
@@ -37,7 +38,7 @@ int main() {
     // Кейс с переполнением
     uint2022_t max;
     for (int i = 0; i < uint2022_t::CAPACITY; ++i) {
-        max.data[i] = 0xFFFFFFFF;
+        max.data[i] = ~(uint2022_t::limb_t)0;
     }
     uint2022_t one = from_uint(1);
     uint2022_t two = from_uint(2);
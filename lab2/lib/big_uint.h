@@ -0,0 +1,1056 @@
+#pragma once
+#include <charconv>
+#include <cinttypes>
+#include <iostream>
+
+// Размер слова выбирается при сборке: 64 бита, если компилятор умеет
+// unsigned __int128 (полное произведение двух слов), иначе 32.
+// Можно задать явно через -DUINT2022_LIMB_BITS=32 или 64
+#ifndef UINT2022_LIMB_BITS
+#ifdef __SIZEOF_INT128__
+#define UINT2022_LIMB_BITS 64
+#else
+#define UINT2022_LIMB_BITS 32
+#endif
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define BIG_UINT_X86_CARRY
+#endif
+
+// Интринсики переноса не constexpr: при вычислении во время компиляции
+// работает переносимая ветка через двойное слово
+#if defined(__GNUC__) || defined(__clang__)
+#define BIG_UINT_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define BIG_UINT_CONSTANT_EVALUATED() true
+#endif
+
+// Операции над массивами слов, общие для всех ширин BigUint
+namespace big_uint_detail {
+
+#if UINT2022_LIMB_BITS == 64
+using limb_t = uint64_t;
+using dlimb_t = unsigned __int128; // Полное произведение двух слов
+#else
+using limb_t = uint32_t;
+using dlimb_t = uint64_t;
+#endif
+
+constexpr int LIMB_BITS = UINT2022_LIMB_BITS;
+
+// a + b + carry, новый перенос записывается в carry. На x86-64 через
+// _addcarry_u*: компилятор собирает цепочку в adc без сохранения флага
+constexpr limb_t add_carry(limb_t a, limb_t b, unsigned char& carry) {
+#ifdef BIG_UINT_X86_CARRY
+    if (!BIG_UINT_CONSTANT_EVALUATED()) {
+#if UINT2022_LIMB_BITS == 64
+        unsigned long long out = 0;
+        carry = _addcarry_u64(carry, a, b, &out);
+#else
+        unsigned int out = 0;
+        carry = _addcarry_u32(carry, a, b, &out);
+#endif
+        return out;
+    }
+#endif
+    dlimb_t sum = (dlimb_t)a + b + carry;
+    carry = (unsigned char)(sum >> LIMB_BITS);
+    return (limb_t)sum;
+}
+
+// a - b - borrow, новый заём записывается в borrow (sbb на x86-64)
+constexpr limb_t sub_borrow(limb_t a, limb_t b, unsigned char& borrow) {
+#ifdef BIG_UINT_X86_CARRY
+    if (!BIG_UINT_CONSTANT_EVALUATED()) {
+#if UINT2022_LIMB_BITS == 64
+        unsigned long long out = 0;
+        borrow = _subborrow_u64(borrow, a, b, &out);
+#else
+        unsigned int out = 0;
+        borrow = _subborrow_u32(borrow, a, b, &out);
+#endif
+        return out;
+    }
+#endif
+    limb_t diff = a - b - borrow;
+    borrow = (a < b || (a == b && borrow != 0)) ? 1 : 0;
+    return diff;
+}
+
+// Число ведущих нулевых битов ненулевого слова
+constexpr int leading_zeros(limb_t x) {
+#if UINT2022_LIMB_BITS == 64
+    return __builtin_clzll(x);
+#else
+    return __builtin_clz(x);
+#endif
+}
+
+// Число младших нулевых битов ненулевого слова
+constexpr int trailing_zeros(limb_t x) {
+#if UINT2022_LIMB_BITS == 64
+    return __builtin_ctzll(x);
+#else
+    return __builtin_ctz(x);
+#endif
+}
+
+// Число единичных битов слова
+constexpr int popcount_limb(limb_t x) {
+#if UINT2022_LIMB_BITS == 64
+    return __builtin_popcountll(x);
+#else
+    return __builtin_popcount(x);
+#endif
+}
+
+// Десятичных цифр в 2^bits - 1, то есть floor(bits * lg 2) + 1
+// (точно при bits <= 32768)
+constexpr int decimal_digits(int bits) {
+    return (int)((uint64_t)bits * 301029995663981ULL / 1000000000000000ULL) + 1;
+}
+
+// Числа до SMALL_LIMBS слов обрабатываются по всем словам: границы циклов
+// известны при компиляции и циклы разворачиваются, а поиск значащих слов
+// стоил бы больше самой операции
+constexpr int SMALL_LIMBS = 8;
+
+// Порог Карацубы в словах: если короче множитель меньше порога,
+// школьное умножение быстрее. Подобран замером: около 1024 бит паритет
+// (32 слова по 32 бита или 16 по 64), дальше Карацуба выигрывает 20-30%
+constexpr int KARATSUBA_THRESHOLD = 1024 / LIMB_BITS;
+
+constexpr void fill_limbs(limb_t* out, int n, limb_t value) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = value;
+    }
+}
+
+constexpr void copy_limbs(const limb_t* a, int n, limb_t* out) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = a[i];
+    }
+}
+
+// Число значащих слов среди a[0 .. n) (без старших нулей).
+// Нулевые старшие слова пропускаются блоками по 8: проверку блока
+// компилятор векторизует, так что для малых чисел это дешевле любого
+// прохода с переносом
+constexpr int significant_limbs(const limb_t* a, int n) {
+    while (n >= 8) {
+        limb_t any = 0;
+        for (int i = n - 8; i < n; ++i) {
+            any |= a[i];
+        }
+        if (any != 0) {
+            break;
+        }
+        n -= 8;
+    }
+    while (n > 0 && a[n - 1] == 0) {
+        --n;
+    }
+    return n;
+}
+
+// Сравнение значащих частей: -1, 0 или 1
+constexpr int compare(const limb_t* a, int na, const limb_t* b, int nb) {
+    if (na != nb) {
+        return na < nb ? -1 : 1;
+    }
+    for (int i = na - 1; i >= 0; --i) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// Строка школьного умножения: out[0 .. nb) += a * b[0 .. nb),
+// возвращает старшее слово. Произведение слов и два слагаемых
+// помещаются в двойное слово без переполнения
+constexpr limb_t mul_add_row(limb_t a, const limb_t* b, int nb, limb_t* out) {
+    limb_t x = 0;
+
+    for (int j = 0; j < nb; ++j) {
+        dlimb_t temp = (dlimb_t)a * b[j] + out[j] + x;
+        out[j] = (limb_t)temp;
+        x = (limb_t)(temp >> LIMB_BITS);
+    }
+    return x;
+}
+
+// Школьное умножение: out[0 .. na + nb) = a * b
+constexpr void mul_schoolbook(const limb_t* a, int na, const limb_t* b, int nb, limb_t* out) {
+    fill_limbs(out, na + nb, 0);
+
+    for (int i = 0; i < na; ++i) {
+        out[i + nb] = mul_add_row(a[i], b, nb, out + i);
+    }
+}
+
+// out[0 .. n_out) += a[0 .. na), перенос распространяется до конца out
+constexpr void add_to(limb_t* out, int n_out, const limb_t* a, int na) {
+    unsigned char x = 0;
+    int i = 0;
+
+    for (; i < na; ++i) {
+        out[i] = add_carry(out[i], a[i], x);
+    }
+    for (; x != 0 && i < n_out; ++i) {
+        out[i] = add_carry(out[i], 0, x);
+    }
+}
+
+// out[0 .. n_out) -= a[0 .. na); результат должен быть неотрицательным
+constexpr void sub_from(limb_t* out, int n_out, const limb_t* a, int na) {
+    unsigned char x = 0;
+    int i = 0;
+
+    for (; i < na; ++i) {
+        out[i] = sub_borrow(out[i], a[i], x);
+    }
+    for (; x != 0 && i < n_out; ++i) {
+        out[i] = sub_borrow(out[i], 0, x);
+    }
+}
+
+// out[0 .. h + 1) = a[0 .. m) + a[m .. m + h), где h >= m
+constexpr void add_halves(const limb_t* a, int m, int h, limb_t* out) {
+    copy_limbs(a + m, h, out);
+    out[h] = 0;
+    add_to(out, h + 1, a, m);
+}
+
+// Карацуба для двух n-словных множителей: out[0 .. 2n) = a * b.
+// a = a1 * B^m + a0, b = b1 * B^m + b0;
+// a * b = z2 * B^2m + (z1 - z2 - z0) * B^m + z0, где z1 = (a0 + a1)(b0 + b1).
+// Capacity — ширина числа в словах, по ней выбираются размеры буферов
+template <int Capacity>
+constexpr void mul_karatsuba(const limb_t* a, const limb_t* b, int n, limb_t* out) {
+    if (n < KARATSUBA_THRESHOLD) {
+        mul_schoolbook(a, n, b, n, out);
+        return;
+    }
+
+    int m = n / 2;
+    int h = n - m;
+
+    // z0 и z2 записываются прямо на свои места в out
+    mul_karatsuba<Capacity>(a, b, m, out);
+    mul_karatsuba<Capacity>(a + m, b + m, h, out + 2 * m);
+
+    limb_t sa[Capacity / 2 + 2] = {};
+    limb_t sb[Capacity / 2 + 2] = {};
+    limb_t z1[Capacity + 4] = {};
+    add_halves(a, m, h, sa);
+    add_halves(b, m, h, sb);
+    mul_karatsuba<Capacity>(sa, sb, h + 1, z1);
+
+    int n_z1 = 2 * (h + 1);
+    sub_from(z1, n_z1, out, 2 * m);
+    sub_from(z1, n_z1, out + 2 * m, 2 * h);
+
+    // Средний член меньше B^(n + 1), старшие слова z1 нулевые
+    add_to(out + m, 2 * n - m, z1, n_z1 < 2 * n - m ? n_z1 : 2 * n - m);
+}
+
+// Полное произведение: out[0 .. na + nb) = a * b
+template <int Capacity>
+constexpr void mul_limbs(const limb_t* a, int na, const limb_t* b, int nb, limb_t* out) {
+    if (na < nb) {
+        const limb_t* t = a;
+        a = b;
+        b = t;
+        int nt = na;
+        na = nb;
+        nb = nt;
+    }
+    if (nb < KARATSUBA_THRESHOLD) {
+        mul_schoolbook(a, na, b, nb, out);
+        return;
+    }
+
+    // Длинный множитель режется на куски длины nb, каждый умножается по Карацубе
+    fill_limbs(out, na + nb, 0);
+    limb_t piece[2 * Capacity] = {};
+
+    for (int offset = 0; offset < na; offset += nb) {
+        int len = nb < na - offset ? nb : na - offset;
+        if (len == nb) {
+            mul_karatsuba<Capacity>(a + offset, b, nb, piece);
+        } else {
+            mul_limbs<Capacity>(b, nb, a + offset, len, piece);
+        }
+        add_to(out + offset, na + nb - offset, piece, len + nb);
+    }
+}
+
+// Деление на одно слово: q = a / d, возвращает остаток
+constexpr limb_t divide_by_limb(const limb_t* a, int na, limb_t d, limb_t* q) {
+    limb_t rem = 0;
+
+    for (int i = na - 1; i >= 0; --i) {
+        dlimb_t cur = ((dlimb_t)rem << LIMB_BITS) | a[i];
+        q[i] = (limb_t)(cur / d);
+        rem = (limb_t)(cur - (dlimb_t)q[i] * d);
+    }
+    return rem;
+}
+
+// out[0 .. n) = a[0 .. n) << s, где 0 <= s < LIMB_BITS; возвращает выдвинутые биты
+constexpr limb_t shift_limbs_left(const limb_t* a, int n, int s, limb_t* out) {
+    if (s == 0) {
+        copy_limbs(a, n, out);
+        return 0;
+    }
+    limb_t high = a[n - 1] >> (LIMB_BITS - s);
+    for (int i = n - 1; i > 0; --i) {
+        out[i] = (a[i] << s) | (a[i - 1] >> (LIMB_BITS - s));
+    }
+    out[0] = a[0] << s;
+    return high;
+}
+
+// Деление столбиком по словам (Кнут, т. 2, 4.3.1, алгоритм D).
+// Делитель нормализуется сдвигом так, чтобы старший бит его старшего
+// слова был единицей: тогда оценка очередной цифры частного по двум
+// старшим словам ошибается не больше чем на 2 и уточняется сравнением
+// с третьим словом. nb >= 2, na >= nb
+template <int Capacity>
+constexpr void divide_knuth(const limb_t* a, int na, const limb_t* b, int nb, limb_t* q, limb_t* r) {
+    limb_t un[Capacity + 1] = {};
+    limb_t vn[Capacity] = {};
+    int s = leading_zeros(b[nb - 1]);
+
+    shift_limbs_left(b, nb, s, vn);
+    un[na] = shift_limbs_left(a, na, s, un);
+
+    const dlimb_t base = (dlimb_t)1 << LIMB_BITS;
+    for (int j = na - nb; j >= 0; --j) {
+        // Оценка цифры частного по двум старшим словам остатка
+        dlimb_t num = ((dlimb_t)un[j + nb] << LIMB_BITS) | un[j + nb - 1];
+        dlimb_t qhat = num / vn[nb - 1];
+        dlimb_t rhat = num - qhat * vn[nb - 1];
+
+        while (qhat >= base || qhat * vn[nb - 2] > ((rhat << LIMB_BITS) | un[j + nb - 2])) {
+            --qhat;
+            rhat += vn[nb - 1];
+            if (rhat >= base) {
+                break;
+            }
+        }
+
+        // un[j .. j + nb] -= qhat * vn
+        limb_t k = 0;
+        unsigned char borrow = 0;
+        for (int i = 0; i < nb; ++i) {
+            dlimb_t p = qhat * vn[i] + k;
+            k = (limb_t)(p >> LIMB_BITS);
+            un[i + j] = sub_borrow(un[i + j], (limb_t)p, borrow);
+        }
+        un[j + nb] = sub_borrow(un[j + nb], k, borrow);
+
+        // Оценка оказалась на единицу больше: возвращаем делитель
+        if (borrow != 0) {
+            --qhat;
+            unsigned char x = 0;
+            for (int i = 0; i < nb; ++i) {
+                un[i + j] = add_carry(un[i + j], vn[i], x);
+            }
+            un[j + nb] += x;
+        }
+        q[j] = (limb_t)qhat;
+    }
+
+    // Остаток — нормализованный остаток, сдвинутый обратно
+    for (int i = 0; i < nb - 1; ++i) {
+        r[i] = (un[i] >> s) | (s == 0 ? 0 : un[i + 1] << (LIMB_BITS - s));
+    }
+    r[nb - 1] = un[nb - 1] >> s;
+}
+
+// a[0 .. na) делится на b[0 .. nb), nb >= 1, a >= b: частное в q[0 .. na - nb + 1)
+// (при nb == 1 — в q[0 .. na)), остаток в r[0 .. nb). q может совпадать с a,
+// r тоже: делимое прочитано раньше, чем пишутся частное и остаток
+template <int Capacity>
+constexpr void divide_limbs(const limb_t* a, int na, const limb_t* b, int nb, limb_t* q, limb_t* r) {
+    if (nb == 1) {
+        r[0] = divide_by_limb(a, na, b[0], q);
+        return;
+    }
+    // В однословном числе делитель всегда из одного слова
+    if constexpr (Capacity >= 2) {
+        divide_knuth<Capacity>(a, na, b, nb, q, r);
+    }
+}
+
+// Десятичные преобразования работают порциями по CHUNK_DIGITS цифр
+// (наибольшая степень десяти, помещающаяся в слово), поэтому на порцию
+// приходится одно деление или умножение на слово вместо операции над
+// всем числом на каждую цифру
+#if UINT2022_LIMB_BITS == 64
+constexpr limb_t CHUNK_BASE = 10000000000000000000ULL;
+constexpr int CHUNK_DIGITS = 19;
+#else
+constexpr limb_t CHUNK_BASE = 1000000000;
+constexpr int CHUNK_DIGITS = 9;
+#endif
+
+// При выводе числа от этой длины (640 бит) делятся на 10^(CHUNK_DIGITS * 2^k),
+// и частное и остаток выводятся независимо: одно деление по алгоритму D
+// заменяет много проходов деления на слово по всему числу (для
+// 2240-битного числа быстрее примерно на треть). При разборе такое
+// разбиение не окупается: умножение на порцию по значащим словам
+// дешевле полного умножения половин
+constexpr int SPLIT_LIMBS = 640 / LIMB_BITS;
+
+// Число степеней 10^(CHUNK_DIGITS * 2^k), меньших 2^bits
+constexpr int count_split_powers(int bits) {
+    int k = 1;
+    while ((CHUNK_DIGITS << k) < decimal_digits(bits)) {
+        ++k;
+    }
+    return k;
+}
+
+// a[0 .. n) = a * CHUNK_BASE + chunk на месте; n — значащие слова a, capacity —
+// ширина в словах. Возвращает false, если результат не поместился
+// (лишние старшие разряды отбрасываются)
+constexpr bool mul_add_chunk(limb_t* a, int& n, int capacity, limb_t chunk) {
+    limb_t x = chunk;
+
+    for (int i = 0; i < n; ++i) {
+        dlimb_t temp = (dlimb_t)a[i] * CHUNK_BASE + x;
+        a[i] = (limb_t)temp;
+        x = (limb_t)(temp >> LIMB_BITS);
+    }
+    if (x == 0) {
+        return true;
+    }
+    if (n == capacity) {
+        return false;
+    }
+    a[n++] = x;
+    return true;
+}
+
+// Цифры [first, last) порциями по CHUNK_DIGITS (первая порция может быть
+// короче) в a[0 .. capacity), которое должно быть нулевым. Возвращает
+// false при переполнении; результат тогда взят по модулю
+constexpr bool parse_chunks(const char* first, const char* last, limb_t* a, int capacity) {
+    bool fits = true;
+    int n = 0;
+    int head = (int)((last - first) % CHUNK_DIGITS);
+    if (head == 0) {
+        head = CHUNK_DIGITS;
+    }
+
+    while (first < last) {
+        limb_t chunk = 0;
+        for (const char* end = first + head; first < end; ++first) {
+            chunk = chunk * 10 + (limb_t)(*first - '0');
+        }
+        fits = mul_add_chunk(a, n, capacity, chunk) && fits;
+        head = CHUNK_DIGITS;
+    }
+    return fits;
+}
+
+constexpr const char* skip_digits(const char* first, const char* last) {
+    while (first != last && *first >= '0' && *first <= '9') {
+        ++first;
+    }
+    return first;
+}
+
+} // namespace big_uint_detail
+
+// Беззнаковое целое фиксированной ширины Bits (кратной 64). Арифметика
+// по модулю 2^Bits; все операции, кроме вывода, constexpr
+template <int Bits>
+struct BigUint {
+    static_assert(Bits > 0 && Bits % 64 == 0 && Bits <= 32768, "BigUint width must be a multiple of 64 up to 32768");
+
+    using limb_t = big_uint_detail::limb_t;
+    static constexpr int LIMB_BITS = big_uint_detail::LIMB_BITS;
+    static constexpr int CAPACITY = Bits / LIMB_BITS;
+    static constexpr int MAX_DIGITS = big_uint_detail::decimal_digits(Bits); // Десятичных цифр в 2^Bits - 1
+    limb_t data[CAPACITY] = {};  // Массив слов, младший разряд — data[0]
+
+    // Преобразование из целого
+    static constexpr BigUint from_uint(uint64_t value) {
+        BigUint result;
+        result.data[0] = (limb_t)value;
+        if constexpr (LIMB_BITS < 64) {
+            result.data[1] = (limb_t)(value >> 32);
+        }
+        return result;
+    }
+
+    // Преобразование из десятичной строки (разбор идёт до первого символа,
+    // не являющегося цифрой; лишние старшие разряды отбрасываются по модулю)
+    static constexpr BigUint from_string(const char* ch) {
+        const char* end = ch;
+        while (*end >= '0' && *end <= '9') {
+            ++end;
+        }
+        BigUint result;
+        big_uint_detail::parse_chunks(ch, end, result.data, CAPACITY);
+        return result;
+    }
+};
+
+// Частное и остаток одного деления
+template <int Bits>
+struct BigUintDivmod {
+    BigUint<Bits> quotient;
+    BigUint<Bits> remainder;
+};
+
+// Число значащих слов в data (0 для нуля). Длина не хранится в структуре,
+// потому что data можно заполнять напрямую; она вычисляется быстрым
+// просмотром старших слов, и операции над широкими числами работают
+// только с этой частью
+template <int Bits>
+constexpr int significant_limbs(const BigUint<Bits>& value) {
+    return big_uint_detail::significant_limbs(value.data, BigUint<Bits>::CAPACITY);
+}
+
+// Слова, по которым идёт операция: у узких чисел все, у широких значащие
+template <int Bits>
+constexpr int active_limbs(const BigUint<Bits>& value) {
+    if constexpr (BigUint<Bits>::CAPACITY <= big_uint_detail::SMALL_LIMBS) {
+        return BigUint<Bits>::CAPACITY;
+    } else {
+        return significant_limbs(value);
+    }
+}
+
+// Составные операторы работают на месте: в горячих циклах это избавляет
+// от копирования временных чисел (для uint2022_t по 280 байт)
+
+// Сложение на месте
+template <int Bits>
+constexpr BigUint<Bits>& operator+=(BigUint<Bits>& first, const BigUint<Bits>& second) {
+    unsigned char x = 0;
+    int na = active_limbs(first);
+    int nb = active_limbs(second);
+    int n = na > nb ? na : nb;
+
+    for (int i = 0; i < n; ++i) {
+        first.data[i] = big_uint_detail::add_carry(first.data[i], second.data[i], x);
+    }
+    if (n < BigUint<Bits>::CAPACITY) {
+        first.data[n] = x;
+    }
+
+    return first;
+}
+
+// Вычитание на месте
+template <int Bits>
+constexpr BigUint<Bits>& operator-=(BigUint<Bits>& first, const BigUint<Bits>& second) {
+    unsigned char x = 0;
+    int na = active_limbs(first);
+    int nb = active_limbs(second);
+    int n = na > nb ? na : nb;
+
+    for (int i = 0; i < n; ++i) {
+        first.data[i] = big_uint_detail::sub_borrow(first.data[i], second.data[i], x);
+    }
+
+    // Вычитаемое больше: заём уходит во все старшие слова (результат по модулю)
+    if (x != 0) {
+        big_uint_detail::fill_limbs(first.data + n, BigUint<Bits>::CAPACITY - n, ~(big_uint_detail::limb_t)0);
+    }
+
+    return first;
+}
+
+namespace big_uint_detail {
+
+// Карацуба возможна, только если в число помещаются два множителя длины
+// не меньше порога; для узких чисел её код даже не инстанцируется
+template <int Capacity>
+constexpr bool KARATSUBA_ENABLED = Capacity >= 2 * KARATSUBA_THRESHOLD;
+
+// Произведение поместится целиком и множители достаточно длинные для Карацубы
+template <int Capacity>
+constexpr bool use_karatsuba(int na, int nb) {
+    return (na < nb ? na : nb) >= KARATSUBA_THRESHOLD && na + nb <= Capacity;
+}
+
+// acc[0 .. Capacity) += a[0 .. na) * b[0 .. nb) по модулю; acc не должен
+// совпадать с множителями. Если произведение не помещается, усечённый
+// школьный алгоритм не считает отбрасываемые старшие слова и оказывается
+// быстрее полного по Карацубе
+template <int Capacity>
+constexpr void add_product(limb_t* acc, const limb_t* a, int na, const limb_t* b, int nb) {
+    if constexpr (KARATSUBA_ENABLED<Capacity>) {
+        if (use_karatsuba<Capacity>(na, nb)) {
+            limb_t product[2 * Capacity] = {};
+            mul_limbs<Capacity>(a, na, b, nb, product);
+            add_to(acc, Capacity, product, na + nb);
+            return;
+        }
+    }
+
+    for (int i = 0; i < na; ++i) {
+        int len = nb < Capacity - i ? nb : Capacity - i;
+        limb_t x = mul_add_row(a[i], b, len, acc + i);
+        add_to(acc + i + len, Capacity - i - len, &x, i + len < Capacity ? 1 : 0);
+    }
+}
+
+} // namespace big_uint_detail
+
+// Умножение на месте. Строки школьного алгоритма идут от старшего слова
+// first к младшему: строка i пишет только в слова с номерами >= i, а
+// младшие слова first ещё не использованы, поэтому буфер не нужен
+template <int Bits>
+constexpr BigUint<Bits>& operator*=(BigUint<Bits>& first, const BigUint<Bits>& second) {
+    const int capacity = BigUint<Bits>::CAPACITY;
+    if (&first == &second) {
+        BigUint<Bits> copy = second;
+        return first *= copy;
+    }
+    int na = active_limbs(first);
+    int nb = active_limbs(second);
+
+    if constexpr (big_uint_detail::KARATSUBA_ENABLED<capacity>) {
+        if (big_uint_detail::use_karatsuba<capacity>(na, nb)) {
+            big_uint_detail::limb_t product[2 * capacity] = {};
+            big_uint_detail::mul_limbs<capacity>(first.data, na, second.data, nb, product);
+            big_uint_detail::copy_limbs(product, na + nb, first.data);
+            return first;
+        }
+    }
+
+    for (int i = na - 1; i >= 0; --i) {
+        big_uint_detail::limb_t digit = first.data[i];
+        first.data[i] = 0;
+        int len = nb < capacity - i ? nb : capacity - i;
+        big_uint_detail::limb_t x = big_uint_detail::mul_add_row(digit, second.data, len, first.data + i);
+        big_uint_detail::add_to(first.data + i + len, capacity - i - len, &x, i + len < capacity ? 1 : 0);
+    }
+    return first;
+}
+
+// Деление на месте (при делении на ноль результат нулевой)
+template <int Bits>
+constexpr BigUint<Bits>& operator/=(BigUint<Bits>& first, const BigUint<Bits>& second) {
+    int na = significant_limbs(first);
+    int nb = significant_limbs(second);
+
+    if (nb == 0 || big_uint_detail::compare(first.data, na, second.data, nb) < 0) {
+        big_uint_detail::fill_limbs(first.data, na, 0);
+        return first;
+    }
+
+    // Частное пишется поверх делимого: оба алгоритма успевают прочитать
+    // слово делимого до записи слова частного на его место
+    BigUint<Bits> remainder;
+    big_uint_detail::divide_limbs<BigUint<Bits>::CAPACITY>(first.data, na, second.data, nb, first.data, remainder.data);
+    big_uint_detail::fill_limbs(first.data + na - nb + 1, nb - 1, 0);
+    return first;
+}
+
+// Остаток на месте (при делении на ноль результат нулевой)
+template <int Bits>
+constexpr BigUint<Bits>& operator%=(BigUint<Bits>& first, const BigUint<Bits>& second) {
+    int na = significant_limbs(first);
+    int nb = significant_limbs(second);
+
+    if (nb == 0) {
+        big_uint_detail::fill_limbs(first.data, na, 0);
+        return first;
+    }
+    if (big_uint_detail::compare(first.data, na, second.data, nb) < 0) {
+        return first;
+    }
+
+    // Остаток записывается после того, как делимое прочитано целиком
+    BigUint<Bits> quotient;
+    big_uint_detail::divide_limbs<BigUint<Bits>::CAPACITY>(first.data, na, second.data, nb, quotient.data, first.data);
+    big_uint_detail::fill_limbs(first.data + nb, na - nb, 0);
+    return first;
+}
+
+// Сдвиг влево на shift >= 0 бит на месте (выдвинутые за ширину биты теряются)
+template <int Bits>
+constexpr BigUint<Bits>& operator<<=(BigUint<Bits>& value, int shift) {
+    const int capacity = BigUint<Bits>::CAPACITY;
+    const int limb_bits = BigUint<Bits>::LIMB_BITS;
+    if (shift >= Bits) {
+        big_uint_detail::fill_limbs(value.data, capacity, 0);
+        return value;
+    }
+    int limbs = shift / limb_bits;
+    int bits = shift % limb_bits;
+    int n = active_limbs(value);
+    int top = n + limbs + 1 < capacity ? n + limbs + 1 : capacity;
+
+    // От старших слов к младшим: источник всегда не выше приёмника
+    for (int i = top - 1; i > limbs; --i) {
+        value.data[i] = bits == 0 ? value.data[i - limbs]
+                                  : (value.data[i - limbs] << bits) | (value.data[i - limbs - 1] >> (limb_bits - bits));
+    }
+    value.data[limbs] = value.data[0] << bits;
+    big_uint_detail::fill_limbs(value.data, limbs, 0);
+    return value;
+}
+
+// Сдвиг вправо на shift >= 0 бит на месте
+template <int Bits>
+constexpr BigUint<Bits>& operator>>=(BigUint<Bits>& value, int shift) {
+    const int limb_bits = BigUint<Bits>::LIMB_BITS;
+    int n = active_limbs(value);
+    int limbs = shift / limb_bits;
+    int bits = shift % limb_bits;
+    if (shift >= Bits || limbs >= n) {
+        big_uint_detail::fill_limbs(value.data, n, 0);
+        return value;
+    }
+    int count = n - limbs;
+
+    // От младших слов к старшим: источник всегда не ниже приёмника
+    for (int i = 0; i + 1 < count; ++i) {
+        value.data[i] = bits == 0 ? value.data[i + limbs]
+                                  : (value.data[i + limbs] >> bits) | (value.data[i + limbs + 1] << (limb_bits - bits));
+    }
+    value.data[count - 1] = value.data[n - 1] >> bits;
+    big_uint_detail::fill_limbs(value.data + count, limbs, 0);
+    return value;
+}
+
+// Префиксный инкремент: перенос идёт только до первого ненулевого слова
+template <int Bits>
+constexpr BigUint<Bits>& operator++(BigUint<Bits>& value) {
+    for (int i = 0; i < BigUint<Bits>::CAPACITY; ++i) {
+        if (++value.data[i] != 0) {
+            break;
+        }
+    }
+    return value;
+}
+
+// Постфиксный инкремент
+template <int Bits>
+constexpr BigUint<Bits> operator++(BigUint<Bits>& value, int) {
+    BigUint<Bits> old = value;
+    ++value;
+    return old;
+}
+
+// Побитовое И на месте: слова выше значащих у одного из операндов обнуляются
+template <int Bits>
+constexpr BigUint<Bits>& operator&=(BigUint<Bits>& first, const BigUint<Bits>& second) {
+    int na = active_limbs(first);
+    int nb = active_limbs(second);
+    int n = na < nb ? na : nb;
+
+    for (int i = 0; i < n; ++i) {
+        first.data[i] &= second.data[i];
+    }
+    big_uint_detail::fill_limbs(first.data + n, na - n, 0);
+    return first;
+}
+
+// Побитовое ИЛИ на месте
+template <int Bits>
+constexpr BigUint<Bits>& operator|=(BigUint<Bits>& first, const BigUint<Bits>& second) {
+    int n = active_limbs(second);
+    for (int i = 0; i < n; ++i) {
+        first.data[i] |= second.data[i];
+    }
+    return first;
+}
+
+// Исключающее ИЛИ на месте
+template <int Bits>
+constexpr BigUint<Bits>& operator^=(BigUint<Bits>& first, const BigUint<Bits>& second) {
+    int n = active_limbs(second);
+    for (int i = 0; i < n; ++i) {
+        first.data[i] ^= second.data[i];
+    }
+    return first;
+}
+
+// Оператор сложения
+template <int Bits>
+constexpr BigUint<Bits> operator+(const BigUint<Bits>& first, const BigUint<Bits>& second) {
+    BigUint<Bits> result = first;
+    return result += second;
+}
+
+// Оператор вычитания
+template <int Bits>
+constexpr BigUint<Bits> operator-(const BigUint<Bits>& first, const BigUint<Bits>& second) {
+    BigUint<Bits> result = first;
+    return result -= second;
+}
+
+// Оператор умножения (по модулю 2^Bits, как и остальная арифметика).
+// Произведение накапливается сразу в нулевом результате, без копии first
+template <int Bits>
+constexpr BigUint<Bits> operator*(const BigUint<Bits>& first, const BigUint<Bits>& second) {
+    BigUint<Bits> result;
+    big_uint_detail::add_product<BigUint<Bits>::CAPACITY>(
+        result.data, first.data, active_limbs(first), second.data, active_limbs(second));
+    return result;
+}
+
+// Сдвиги и побитовые операции: по целому слову за шаг
+template <int Bits>
+constexpr BigUint<Bits> operator<<(const BigUint<Bits>& value, int shift) {
+    BigUint<Bits> result = value;
+    return result <<= shift;
+}
+
+template <int Bits>
+constexpr BigUint<Bits> operator>>(const BigUint<Bits>& value, int shift) {
+    BigUint<Bits> result = value;
+    return result >>= shift;
+}
+
+template <int Bits>
+constexpr BigUint<Bits> operator&(const BigUint<Bits>& first, const BigUint<Bits>& second) {
+    BigUint<Bits> result = first;
+    return result &= second;
+}
+
+template <int Bits>
+constexpr BigUint<Bits> operator|(const BigUint<Bits>& first, const BigUint<Bits>& second) {
+    BigUint<Bits> result = first;
+    return result |= second;
+}
+
+template <int Bits>
+constexpr BigUint<Bits> operator^(const BigUint<Bits>& first, const BigUint<Bits>& second) {
+    BigUint<Bits> result = first;
+    return result ^= second;
+}
+
+// Число значащих битов (0 для нуля): value < 2^bit_length(value)
+template <int Bits>
+constexpr int bit_length(const BigUint<Bits>& value) {
+    int n = significant_limbs(value);
+    if (n == 0) {
+        return 0;
+    }
+    return n * BigUint<Bits>::LIMB_BITS - big_uint_detail::leading_zeros(value.data[n - 1]);
+}
+
+// Число единичных битов
+template <int Bits>
+constexpr int popcount(const BigUint<Bits>& value) {
+    int count = 0;
+    int n = active_limbs(value);
+    for (int i = 0; i < n; ++i) {
+        count += big_uint_detail::popcount_limb(value.data[i]);
+    }
+    return count;
+}
+
+// Число младших нулевых битов (Bits для нуля, как std::countr_zero)
+template <int Bits>
+constexpr int countr_zero(const BigUint<Bits>& value) {
+    int n = active_limbs(value);
+    for (int i = 0; i < n; ++i) {
+        if (value.data[i] != 0) {
+            return i * BigUint<Bits>::LIMB_BITS + big_uint_detail::trailing_zeros(value.data[i]);
+        }
+    }
+    return Bits;
+}
+
+// Слитное acc += a * b: произведение прибавляется построчно, без
+// временного числа под него
+template <int Bits>
+constexpr BigUint<Bits>& add_product(BigUint<Bits>& acc, const BigUint<Bits>& a, const BigUint<Bits>& b) {
+    if (&acc == &a || &acc == &b) {
+        BigUint<Bits> copy = acc;
+        return add_product(acc, &acc == &a ? copy : a, &acc == &b ? copy : b);
+    }
+    big_uint_detail::add_product<BigUint<Bits>::CAPACITY>(acc.data, a.data, active_limbs(a), b.data, active_limbs(b));
+    return acc;
+}
+
+// Слитное a * b + c
+template <int Bits>
+constexpr BigUint<Bits> mul_add(const BigUint<Bits>& a, const BigUint<Bits>& b, const BigUint<Bits>& c) {
+    BigUint<Bits> result = c;
+    big_uint_detail::add_product<BigUint<Bits>::CAPACITY>(result.data, a.data, active_limbs(a), b.data, active_limbs(b));
+    return result;
+}
+
+// Деление с остатком за один проход (при делении на ноль оба результата нулевые)
+template <int Bits>
+constexpr BigUintDivmod<Bits> divmod(const BigUint<Bits>& first, const BigUint<Bits>& second) {
+    BigUintDivmod<Bits> result;
+    int na = significant_limbs(first);
+    int nb = significant_limbs(second);
+
+    if (nb == 0) {
+        return result; // Защита от деления на ноль
+    }
+    if (big_uint_detail::compare(first.data, na, second.data, nb) < 0) {
+        result.remainder = first;
+        return result;
+    }
+
+    big_uint_detail::divide_limbs<BigUint<Bits>::CAPACITY>(
+        first.data, na, second.data, nb, result.quotient.data, result.remainder.data);
+    return result;
+}
+
+// Оператор деления
+template <int Bits>
+constexpr BigUint<Bits> operator/(const BigUint<Bits>& first, const BigUint<Bits>& second) {
+    BigUint<Bits> result = first;
+    return result /= second;
+}
+
+// Остаток от деления: first % second
+template <int Bits>
+constexpr BigUint<Bits> operator%(const BigUint<Bits>& first, const BigUint<Bits>& second) {
+    BigUint<Bits> result = first;
+    return result %= second;
+}
+
+// Проверка на равенство
+template <int Bits>
+constexpr bool operator==(const BigUint<Bits>& first, const BigUint<Bits>& second) {
+    return big_uint_detail::compare(first.data, active_limbs(first), second.data, active_limbs(second)) == 0;
+}
+
+// Проверка на неравенство
+template <int Bits>
+constexpr bool operator!=(const BigUint<Bits>& first, const BigUint<Bits>& second) {
+    return !(first == second);
+}
+
+namespace big_uint_detail {
+
+// Вспомогательное сравнение: a < b
+template <int Bits>
+constexpr bool less_than(const BigUint<Bits>& a, const BigUint<Bits>& b) {
+    return compare(a.data, active_limbs(a), b.data, active_limbs(b)) < 0;
+}
+
+// Степени 10^(CHUNK_DIGITS * 2^k), которые помещаются в BigUint<Bits>
+template <int Bits>
+const BigUint<Bits>& split_power(int k) {
+    static const struct Table {
+        BigUint<Bits> powers[count_split_powers(Bits)];
+
+        Table() {
+            powers[0].data[0] = CHUNK_BASE;
+            for (int i = 1; i < count_split_powers(Bits); ++i) {
+                powers[i] = powers[i - 1] * powers[i - 1];
+            }
+        }
+    } table;
+    return table.powers[k];
+}
+
+// Записывает цифры value так, чтобы последняя оказалась перед end, и
+// дополняет нулями до min_digits. Возвращает указатель на первую цифру
+template <int Bits>
+char* format_chunks(BigUint<Bits> value, char* end, int min_digits) {
+    char* p = end;
+    int n = significant_limbs(value);
+
+    while (n > 0) {
+        limb_t chunk = divide_by_limb(value.data, n, CHUNK_BASE, value.data);
+        if (value.data[n - 1] == 0) {
+            --n;
+        }
+        // Внутренние порции всегда по CHUNK_DIGITS цифр, у старшей — без ведущих нулей
+        for (int i = 0; i < CHUNK_DIGITS && (n > 0 || chunk != 0); ++i) {
+            *--p = (char)('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+    while (end - p < min_digits) {
+        *--p = '0';
+    }
+    return p;
+}
+
+template <int Bits>
+char* format_decimal(const BigUint<Bits>& value, char* end, int min_digits) {
+    if (significant_limbs(value) < SPLIT_LIMBS) {
+        return format_chunks(value, end, min_digits);
+    }
+
+    // Наибольшая степень, не превосходящая value: частное и остаток
+    // получаются сравнимой длины
+    int k = 0;
+    while (k + 1 < count_split_powers(Bits) && !less_than(value, split_power<Bits>(k + 1))) {
+        ++k;
+    }
+    int low_digits = CHUNK_DIGITS << k;
+    BigUintDivmod<Bits> parts = divmod(value, split_power<Bits>(k));
+
+    format_decimal(parts.remainder, end, low_digits);
+    return format_decimal(parts.quotient, end - low_digits, min_digits > low_digits ? min_digits - low_digits : 0);
+}
+
+} // namespace big_uint_detail
+
+// Десятичная запись в буфер вызывающего [first, last), без завершающего нуля.
+// Как std::to_chars: при нехватке места возвращает errc::value_too_large.
+// Буфера из MAX_DIGITS символов хватает всегда
+template <int Bits>
+std::to_chars_result to_chars(char* first, char* last, const BigUint<Bits>& value) {
+    char buffer[BigUint<Bits>::MAX_DIGITS];
+    char* end = buffer + BigUint<Bits>::MAX_DIGITS;
+    char* begin = big_uint_detail::format_decimal(value, end, 1);
+
+    if (last - first < end - begin) {
+        return {last, std::errc::value_too_large};
+    }
+    for (const char* p = begin; p != end; ++p) {
+        *first++ = *p;
+    }
+    return {first, std::errc()};
+}
+
+// Разбор десятичных цифр с начала [first, last), как std::from_chars:
+// ptr указывает на первый символ после числа; если цифр нет —
+// errc::invalid_argument, если число не помещается — errc::result_out_of_range
+// (value в обоих случаях не меняется)
+template <int Bits>
+constexpr std::from_chars_result from_chars(const char* first, const char* last, BigUint<Bits>& value) {
+    const char* end = big_uint_detail::skip_digits(first, last);
+    if (end == first) {
+        return {first, std::errc::invalid_argument};
+    }
+
+    // Ведущие нули не влияют на значение
+    const char* digits = first;
+    while (end - digits > 1 && *digits == '0') {
+        ++digits;
+    }
+    BigUint<Bits> parsed;
+    if (end - digits > BigUint<Bits>::MAX_DIGITS
+        || !big_uint_detail::parse_chunks(digits, end, parsed.data, BigUint<Bits>::CAPACITY)) {
+        return {end, std::errc::result_out_of_range};
+    }
+
+    value = parsed;
+    return {end, std::errc()};
+}
+
+// Вывод в поток
+template <int Bits>
+std::ostream& operator<<(std::ostream& str, const BigUint<Bits>& val) {
+    char buffer[BigUint<Bits>::MAX_DIGITS];
+    std::to_chars_result result = to_chars(buffer, buffer + sizeof(buffer), val);
+    str.write(buffer, result.ptr - buffer);
+    return str;
+}
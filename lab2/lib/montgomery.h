@@ -0,0 +1,222 @@
+#pragma once
+#include "big_uint.h"
+
+// Модульная арифметика по нечётному модулю m в форме Монтгомери: число a
+// хранится как a * R mod m, где R = B^n (B — основание слова, n — значащие
+// слова m). Умножение в этой форме заканчивается редукцией Монтгомери —
+// одним проходом умножения на слово с прибавлением кратного m — вместо
+// деления произведения на m.
+//
+// Для чётного модуля и модуля <= 1 контекст недействителен (valid() == false),
+// и все операции возвращают ноль, как деление на ноль
+template <int Bits>
+class MontgomeryContext {
+public:
+    using number_t = BigUint<Bits>;
+
+    explicit constexpr MontgomeryContext(const number_t& modulus) : mod(modulus) {
+        limbs = significant_limbs(mod);
+        if (limbs == 0 || (mod.data[0] & 1) == 0 || (limbs == 1 && mod.data[0] == 1)) {
+            limbs = 0;
+            return;
+        }
+
+        // -m^(-1) mod B по Ньютону: для нечётного x верно x * x = 1 (mod 8),
+        // и каждый шаг удваивает число верных битов
+        limb_t inv = mod.data[0];
+        for (int i = 0; i < 6; ++i) {
+            inv *= 2 - mod.data[0] * inv;
+        }
+        m_inv = (limb_t)0 - inv;
+
+        // R mod m: если R = 2^Bits не помещается, 2^Bits - m сравнимо с ним
+        if (limbs == number_t::CAPACITY) {
+            one = (number_t() - mod) % mod;
+        } else {
+            number_t r;
+            r.data[limbs] = 1;
+            one = r % mod;
+        }
+
+        // R^2 mod m = (R mod m) * R mod m: R mod m удваивается по модулю
+        // limbs * LIMB_BITS раз. Перед вычитанием 2x < 2m может не поместиться
+        // в Bits битов, но вычитание по модулю 2^Bits всё равно даёт 2x - m
+        r2 = one;
+        const int top_shift = big_uint_detail::LIMB_BITS - 1;
+        for (int i = 0; i < limbs * big_uint_detail::LIMB_BITS; ++i) {
+            bool overflow = (r2.data[number_t::CAPACITY - 1] >> top_shift) != 0;
+            r2 <<= 1;
+            if (overflow || !big_uint_detail::less_than(r2, mod)) {
+                r2 -= mod;
+            }
+        }
+    }
+
+    constexpr bool valid() const {
+        return limbs != 0;
+    }
+
+    constexpr const number_t& modulus() const {
+        return mod;
+    }
+
+    // a -> a * R mod m (a приводится по модулю)
+    constexpr number_t to_montgomery(const number_t& a) const {
+        if (!valid()) {
+            return number_t();
+        }
+        if (big_uint_detail::less_than(a, mod)) {
+            return multiply(a, r2);
+        }
+        return multiply(a % mod, r2);
+    }
+
+    // a * R mod m -> a
+    constexpr number_t from_montgomery(const number_t& a) const {
+        if (!valid()) {
+            return number_t();
+        }
+        return multiply(a, number_t::from_uint(1));
+    }
+
+    // Произведение в форме Монтгомери: a * b * R^(-1) mod m.
+    // a и b — числа в форме Монтгомери (меньше m)
+    constexpr number_t mulmod(const number_t& a, const number_t& b) const {
+        if (!valid()) {
+            return number_t();
+        }
+        return multiply(a, b);
+    }
+
+    // base^exponent mod m для обычных (не Монтгомери) чисел. Скользящее
+    // окно: нечётные степени base^1, base^3, ... base^(2^w - 1) считаются
+    // заранее, и на каждое окно из w битов показателя приходится одно
+    // умножение вместо w
+    constexpr number_t powmod(const number_t& base, const number_t& exponent) const {
+        if (!valid()) {
+            return number_t();
+        }
+        int bits = bit_length(exponent);
+        if (bits == 0) {
+            return number_t::from_uint(1);
+        }
+        int width = window_width(bits);
+
+        number_t odd_powers[1 << (MAX_WINDOW - 1)] = {};
+        odd_powers[0] = to_montgomery(base);
+        number_t square = multiply(odd_powers[0], odd_powers[0]);
+        for (int i = 1; i < (1 << (width - 1)); ++i) {
+            odd_powers[i] = multiply(odd_powers[i - 1], square);
+        }
+
+        number_t result = one;
+        bool started = false;
+        int i = bits - 1;
+        while (i >= 0) {
+            if (!bit(exponent, i)) {
+                if (started) {
+                    result = multiply(result, result);
+                }
+                --i;
+                continue;
+            }
+
+            // Окно [j, i]: не длиннее width битов и кончается единицей
+            int j = i - width + 1 > 0 ? i - width + 1 : 0;
+            while (!bit(exponent, j)) {
+                ++j;
+            }
+            int window = 0;
+            for (int k = i; k >= j; --k) {
+                window = window * 2 + (bit(exponent, k) ? 1 : 0);
+            }
+
+            if (started) {
+                for (int k = i; k >= j; --k) {
+                    result = multiply(result, result);
+                }
+                result = multiply(result, odd_powers[window / 2]);
+            } else {
+                result = odd_powers[window / 2];
+                started = true;
+            }
+            i = j - 1;
+        }
+        return from_montgomery(result);
+    }
+
+private:
+    using limb_t = big_uint_detail::limb_t;
+    using dlimb_t = big_uint_detail::dlimb_t;
+
+    // Наибольшая ширина окна: таблица из 2^(MAX_WINDOW - 1) нечётных степеней
+    static constexpr int MAX_WINDOW = 6;
+
+    number_t mod;
+    number_t one; // R mod m — единица в форме Монтгомери
+    number_t r2;  // R^2 mod m — множитель перевода в форму Монтгомери
+    limb_t m_inv = 0; // -m^(-1) mod B
+    int limbs = 0;    // Значащие слова m (0 — контекст недействителен)
+
+    // Ширина окна по длине показателя: больше окно — меньше умножений
+    // на проход, но дороже таблица (порог — где сумма сравнивается)
+    static constexpr int window_width(int bits) {
+        if (bits <= 24) {
+            return 1;
+        }
+        if (bits <= 80) {
+            return 3;
+        }
+        if (bits <= 240) {
+            return 4;
+        }
+        if (bits <= 672) {
+            return 5;
+        }
+        return MAX_WINDOW;
+    }
+
+    static constexpr bool bit(const number_t& value, int i) {
+        return ((value.data[i / number_t::LIMB_BITS] >> (i % number_t::LIMB_BITS)) & 1) != 0;
+    }
+
+    // a * b * R^(-1) mod m по словам (CIOS): после прибавления a[i] * b
+    // к t прибавляется q * m с q = t[0] * (-m^(-1)) mod B, так что младшее
+    // слово обнуляется и t сдвигается на слово. t < 2m, поэтому в конце
+    // хватает одного вычитания
+    constexpr number_t multiply(const number_t& a, const number_t& b) const {
+        const int n = limbs;
+        const int shift = big_uint_detail::LIMB_BITS;
+        limb_t t[number_t::CAPACITY + 2] = {};
+
+        for (int i = 0; i < n; ++i) {
+            limb_t carry = big_uint_detail::mul_add_row(a.data[i], b.data, n, t);
+            dlimb_t top = (dlimb_t)t[n] + carry;
+            t[n] = (limb_t)top;
+            t[n + 1] = (limb_t)(top >> shift);
+
+            limb_t q = t[0] * m_inv;
+            dlimb_t sum = (dlimb_t)q * mod.data[0] + t[0];
+            carry = (limb_t)(sum >> shift);
+            for (int j = 1; j < n; ++j) {
+                sum = (dlimb_t)q * mod.data[j] + t[j] + carry;
+                t[j - 1] = (limb_t)sum;
+                carry = (limb_t)(sum >> shift);
+            }
+            sum = (dlimb_t)t[n] + carry;
+            t[n - 1] = (limb_t)sum;
+            t[n] = t[n + 1] + (limb_t)(sum >> shift);
+            t[n + 1] = 0;
+        }
+
+        number_t result;
+        big_uint_detail::copy_limbs(t, n, result.data);
+        if (t[n] != 0 || big_uint_detail::compare(t, n, mod.data, n) >= 0) {
+            unsigned char borrow = 0;
+            for (int j = 0; j < n; ++j) {
+                result.data[j] = big_uint_detail::sub_borrow(result.data[j], mod.data[j], borrow);
+            }
+        }
+        return result;
+    }
+};
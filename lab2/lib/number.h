@@ -1,32 +1,28 @@
 #pragma once
-#include <cinttypes>
-#include <iostream>
-#include <cstring>
+#include "big_uint.h"
+#include "montgomery.h"
 
-// Структура для большого целого числа
-struct uint2022_t {
-    static const int CAPACITY = 70; // 70 * 4 = 280 байт < 300 байт
-    uint32_t data[CAPACITY] = {0};  // Массив 32-битных слов, младший разряд — data[0]
-};
+// Структура для большого целого числа: 2240 бит, 280 байт < 300 байт
+// (35 слов по 64 бита или 70 по 32)
+using uint2022_t = BigUint<2240>;
+
+// Частное и остаток одного деления
+using uint2022_divmod_t = BigUintDivmod<2240>;
+
+// Модульная арифметика по Монтгомери для uint2022_t
+using uint2022_montgomery_t = MontgomeryContext<2240>;
 
 static_assert(sizeof(uint2022_t) <= 300, "Size of uint2022_t must be no higher than 300 bytes");
 
 // Преобразование из uint32_t
-uint2022_t from_uint(uint32_t i);
+constexpr uint2022_t from_uint(uint32_t i) {
+    return uint2022_t::from_uint(i);
+}
 
 // Преобразование из строки (десятичное число)
-uint2022_t from_string(const char* ch);
-
-// Арифметика
-uint2022_t operator+(const uint2022_t& first, const uint2022_t& second);
-uint2022_t operator-(const uint2022_t& first, const uint2022_t& second);
-uint2022_t operator*(const uint2022_t& first, const uint2022_t& second);
-uint2022_t operator/(const uint2022_t& first, const uint2022_t& second);
-uint2022_t operator%(const uint2022_t& first, const uint2022_t& second);
-
-// Сравнение
-bool operator==(const uint2022_t& first, const uint2022_t& second);
-bool operator!=(const uint2022_t& first, const uint2022_t& second);
+constexpr uint2022_t from_string(const char* ch) {
+    return uint2022_t::from_string(ch);
+}
 
-// Вывод в консоль
-std::ostream& operator<<(std::ostream& str, const uint2022_t& val);
+// Остальные операции (significant_limbs, арифметика, divmod, сравнение,
+// to_chars / from_chars, вывод) — шаблоны для любой ширины в big_uint.h
@@ -1,5 +1,11 @@
 #include <lib/number.h>
+
 #include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
 #include <tuple>
 
 class ConvertingTestsSuite : public testing::TestWithParam<std::tuple<uint32_t, const char*, bool>> {
@@ -109,4 +115,755 @@ INSTANTIATE_TEST_SUITE_P(
             "1469832487054184013178321496623041557517329857560238757278117847507488415462666081345922349701550571520"
         )
     )
-);
\ No newline at end of file
+);
+
+// Эталоны и случайные числа работают с 32-битными словами и не зависят
+// от размера слова в сборке (uint2022_t::LIMB_BITS)
+const int WORDS = uint2022_t::CAPACITY * uint2022_t::LIMB_BITS / 32;
+
+uint32_t get_word(const uint2022_t& value, int i) {
+    int bit = i * 32;
+    return (uint32_t)(value.data[bit / uint2022_t::LIMB_BITS] >> (bit % uint2022_t::LIMB_BITS));
+}
+
+void set_word(uint2022_t& value, int i, uint32_t word) {
+    int bit = i * 32;
+    int shift = bit % uint2022_t::LIMB_BITS;
+    uint2022_t::limb_t& limb = value.data[bit / uint2022_t::LIMB_BITS];
+    limb = (limb & ~((uint2022_t::limb_t)0xFFFFFFFF << shift)) | ((uint2022_t::limb_t)word << shift);
+}
+
+// Школьное умножение по всем словам (прежняя реализация operator*),
+// эталон для проверки быстрых путей
+uint2022_t schoolbook_multiply(const uint2022_t& first, const uint2022_t& second) {
+    uint32_t words[WORDS] = {0};
+
+    for (int i = 0; i < WORDS; ++i) {
+        uint64_t x = 0;
+
+        for (int j = 0; j + i < WORDS; ++j) {
+            uint64_t temp = (uint64_t)get_word(first, i) * get_word(second, j) + words[i + j] + x;
+            words[i + j] = temp & 0xFFFFFFFF;
+            x = temp >> 32;
+        }
+    }
+
+    uint2022_t result;
+    for (int i = 0; i < WORDS; ++i) {
+        set_word(result, i, words[i]);
+    }
+    return result;
+}
+
+// Сложение и вычитание по всем словам (прежние реализации)
+uint2022_t full_add(const uint2022_t& first, const uint2022_t& second) {
+    uint2022_t result;
+    uint64_t x = 0;
+
+    for (int i = 0; i < WORDS; ++i) {
+        uint64_t sum = (uint64_t)get_word(first, i) + get_word(second, i) + x;
+        set_word(result, i, sum & 0xFFFFFFFF);
+        x = sum >> 32;
+    }
+
+    return result;
+}
+
+uint2022_t full_subtract(const uint2022_t& first, const uint2022_t& second) {
+    uint2022_t result;
+    int64_t x = 0;
+
+    for (int i = 0; i < WORDS; ++i) {
+        int64_t diff = (int64_t)get_word(first, i) - get_word(second, i) - x;
+        x = diff < 0 ? 1 : 0;
+        set_word(result, i, (uint32_t)diff);
+    }
+
+    return result;
+}
+
+// Случайное число из words младших 32-битных слов
+uint2022_t random_number(std::mt19937& rng, int words) {
+    uint2022_t result;
+    for (int i = 0; i < words; ++i) {
+        set_word(result, i, rng());
+    }
+    return result;
+}
+
+class MultiplicationRandomTestsSuite : public testing::TestWithParam<std::tuple<int, int>> {
+};
+
+TEST_P(MultiplicationRandomTestsSuite, MatchesSchoolbookTest) {
+    int first_words = std::get<0>(GetParam());
+    int second_words = std::get<1>(GetParam());
+    std::mt19937 rng(first_words * 1000 + second_words);
+
+    for (int iteration = 0; iteration < 200; ++iteration) {
+        uint2022_t a = random_number(rng, first_words);
+        uint2022_t b = random_number(rng, second_words);
+
+        ASSERT_EQ(a * b, schoolbook_multiply(a, b)) << first_words << " x " << second_words << " words";
+    }
+}
+
+TEST_P(MultiplicationRandomTestsSuite, AllOnesTest) {
+    uint2022_t a;
+    uint2022_t b;
+    for (int i = 0; i < std::get<0>(GetParam()); ++i) {
+        set_word(a, i, 0xFFFFFFFF);
+    }
+    for (int i = 0; i < std::get<1>(GetParam()); ++i) {
+        set_word(b, i, 0xFFFFFFFF);
+    }
+
+    ASSERT_EQ(a * b, schoolbook_multiply(a, b));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Group,
+    MultiplicationRandomTestsSuite,
+    testing::Values(
+        // школьный алгоритм
+        std::make_tuple(1, 1),
+        std::make_tuple(1, 70),
+        std::make_tuple(20, 31),
+        // Карацуба: произведение помещается в CAPACITY
+        std::make_tuple(32, 32),
+        std::make_tuple(35, 35),
+        std::make_tuple(33, 37),
+        std::make_tuple(32, 38),
+        // произведение усекается
+        std::make_tuple(36, 36),
+        std::make_tuple(50, 40),
+        std::make_tuple(70, 70)
+    )
+);
+
+
+class SignificantLimbsTestsSuite : public testing::TestWithParam<std::tuple<int, int>> {
+};
+
+TEST_P(SignificantLimbsTestsSuite, AddSubtractCompareTest) {
+    int first_words = std::get<0>(GetParam());
+    int second_words = std::get<1>(GetParam());
+    std::mt19937 rng(first_words * 1000 + second_words + 1);
+
+    for (int iteration = 0; iteration < 200; ++iteration) {
+        uint2022_t a = random_number(rng, first_words);
+        uint2022_t b = random_number(rng, second_words);
+
+        ASSERT_EQ(a + b, full_add(a, b));
+        ASSERT_EQ(a - b, full_subtract(a, b));
+        ASSERT_EQ(b - a, full_subtract(b, a));
+        ASSERT_EQ(a == b, first_words == 0 && second_words == 0);
+    }
+}
+
+TEST_P(SignificantLimbsTestsSuite, CountTest) {
+    uint2022_t a;
+    int words = std::get<0>(GetParam());
+    if (words > 0) {
+        set_word(a, words - 1, 1);
+    }
+
+    ASSERT_EQ(significant_limbs(a), (words * 32 + uint2022_t::LIMB_BITS - 1) / uint2022_t::LIMB_BITS);
+    ASSERT_EQ(significant_limbs(a * from_uint(0)), 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Group,
+    SignificantLimbsTestsSuite,
+    testing::Values(
+        std::make_tuple(0, 0),
+        std::make_tuple(1, 0),
+        std::make_tuple(1, 1),
+        std::make_tuple(2, 9),
+        std::make_tuple(8, 8),
+        std::make_tuple(17, 16),
+        std::make_tuple(69, 70),
+        std::make_tuple(70, 70)
+    )
+);
+
+TEST(SignificantLimbsTests, CarryIntoNextLimbTest) {
+    ASSERT_EQ(from_string("4294967295") + from_uint(1), from_string("4294967296"));
+    ASSERT_EQ(from_string("4294967296") - from_uint(1), from_string("4294967295"));
+    ASSERT_EQ(from_uint(0) - from_uint(1) + from_uint(1), from_uint(0));
+    // Граница 64-битного слова
+    ASSERT_EQ(from_string("18446744073709551615") + from_uint(1), from_string("18446744073709551616"));
+    ASSERT_EQ(from_string("18446744073709551616") - from_uint(1), from_string("18446744073709551615"));
+}
+
+
+// Побитовое деление (прежняя реализация operator/ и operator%)
+bool full_less_than(const uint2022_t& a, const uint2022_t& b) {
+    for (int i = WORDS - 1; i >= 0; --i) {
+        if (get_word(a, i) != get_word(b, i)) {
+            return get_word(a, i) < get_word(b, i);
+        }
+    }
+    return false;
+}
+
+uint2022_divmod_t bitwise_divmod(const uint2022_t& first, const uint2022_t& second) {
+    uint2022_divmod_t result;
+
+    for (int i = WORDS * 32 - 1; i >= 0; --i) {
+        result.remainder = full_add(result.remainder, result.remainder);
+        set_word(result.remainder, 0, get_word(result.remainder, 0) | ((get_word(first, i / 32) >> (i % 32)) & 1));
+
+        if (!full_less_than(result.remainder, second)) {
+            result.remainder = full_subtract(result.remainder, second);
+            set_word(result.quotient, i / 32, get_word(result.quotient, i / 32) | (1U << (i % 32)));
+        }
+    }
+
+    return result;
+}
+
+class DivisionRandomTestsSuite : public testing::TestWithParam<std::tuple<int, int>> {
+};
+
+TEST_P(DivisionRandomTestsSuite, MatchesBitwiseTest) {
+    int first_words = std::get<0>(GetParam());
+    int second_words = std::get<1>(GetParam());
+    std::mt19937 rng(first_words * 1000 + second_words + 2);
+
+    for (int iteration = 0; iteration < 20; ++iteration) {
+        uint2022_t a = random_number(rng, first_words);
+        uint2022_t b = random_number(rng, second_words);
+        // Маленькие старшие слова делителя проверяют нормализацию
+        if (iteration % 2 == 1) {
+            set_word(b, second_words - 1, rng() % 4 + 1);
+        }
+
+        uint2022_divmod_t expected = bitwise_divmod(a, b);
+        uint2022_divmod_t actual = divmod(a, b);
+
+        ASSERT_EQ(actual.quotient, expected.quotient) << first_words << " / " << second_words << " words";
+        ASSERT_EQ(actual.remainder, expected.remainder) << first_words << " % " << second_words << " words";
+        ASSERT_EQ(a / b, expected.quotient);
+        ASSERT_EQ(a % b, expected.remainder);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Group,
+    DivisionRandomTestsSuite,
+    testing::Values(
+        // делитель из одного слова
+        std::make_tuple(1, 1),
+        std::make_tuple(70, 1),
+        // алгоритм D
+        std::make_tuple(2, 2),
+        std::make_tuple(5, 2),
+        std::make_tuple(40, 17),
+        std::make_tuple(70, 69),
+        std::make_tuple(70, 70),
+        // делимое меньше делителя
+        std::make_tuple(3, 10)
+    )
+);
+
+TEST(DivisionTests, CorrectionStepTest) {
+    // Оценка цифры частного завышена и требует возврата делителя
+    uint2022_t a = from_string("340282366920938463463374607431768211455");
+    uint2022_t b = from_string("18446744073709551617");
+    ASSERT_EQ(a / b, from_string("18446744073709551615"));
+    ASSERT_EQ(a % b, from_uint(0));
+
+    uint2022_t c = from_string("1208925819614629174706175");
+    uint2022_t d = from_string("79228162514264337593543950335");
+    ASSERT_EQ(c / d, from_uint(0));
+    ASSERT_EQ(c % d, c);
+
+    // Пример из Hacker's Delight, где вычитание уходит в минус
+    uint2022_t u;
+    set_word(u, 2, 0x80000000);
+    set_word(u, 3, 0x7FFFFFFF);
+    uint2022_t v;
+    set_word(v, 0, 1);
+    set_word(v, 2, 0x80000000);
+    ASSERT_EQ(u / v, from_string("4294967294"));
+    ASSERT_EQ(u % v, from_string("39614081257132168792477007874"));
+
+    ASSERT_EQ(from_uint(5) / from_uint(0), from_uint(0));
+    ASSERT_EQ(divmod(from_uint(100), from_uint(7)).remainder, from_uint(2));
+}
+
+
+class DecimalTestsSuite : public testing::TestWithParam<const char*> {
+};
+
+TEST_P(DecimalTestsSuite, RoundTripTest) {
+    const char* text = GetParam();
+    uint2022_t value;
+
+    std::from_chars_result parsed = from_chars(text, text + std::strlen(text), value);
+    ASSERT_EQ(parsed.ec, std::errc());
+    ASSERT_EQ(parsed.ptr, text + std::strlen(text));
+    ASSERT_EQ(value, from_string(text));
+
+    char buffer[uint2022_t::MAX_DIGITS];
+    std::to_chars_result written = to_chars(buffer, buffer + sizeof(buffer), value);
+    ASSERT_EQ(written.ec, std::errc());
+    ASSERT_EQ(std::string(buffer, written.ptr), text);
+
+    std::ostringstream out;
+    out << value;
+    ASSERT_EQ(out.str(), text);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Group,
+    DecimalTestsSuite,
+    testing::Values(
+        "0",
+        "7",
+        "999999999",
+        "1000000000",
+        "1000000000000000000",
+        "4294967296",
+        "1469832487054184013178321496623041557517329857560238757278117847507488415462666081345922349701550571520",
+        // 2^2240 - 1: длинный путь с делением пополам и наибольшее значение
+        "2028571348927282222444554037802398897320966318206319106648112301460990628551464730522241303647224363"
+        "0949071572609878635484881611123168084522644835372427545328958067027721796192883007640708111048246558"
+        "7228976018799780290606465698196232041597111159153869078635638735543524306207918549051538549551164404"
+        "5708190718643548202677137997420304828472712354625273953850875049852789852942940367152794233174122360"
+        "8813443774157382835112698270753149374505992040104529532375811968006024406838006684751529938958374928"
+        "6466143251601578398630740197236079859254441981368797290215252030523949959906421461737965638982831197"
+        "169919730369179456856294549967631332332498659945988123043666582894622539775"
+    )
+);
+
+TEST(DecimalTests, RandomRoundTripTest) {
+    std::mt19937 rng(20);
+    char buffer[uint2022_t::MAX_DIGITS];
+
+    for (int words = 0; words <= WORDS; ++words) {
+        uint2022_t value = random_number(rng, words);
+        std::to_chars_result written = to_chars(buffer, buffer + sizeof(buffer), value);
+        ASSERT_EQ(written.ec, std::errc());
+
+        uint2022_t parsed;
+        ASSERT_EQ(from_chars(buffer, written.ptr, parsed).ec, std::errc());
+        ASSERT_EQ(parsed, value) << words << " words";
+    }
+}
+
+TEST(DecimalTests, ErrorsTest) {
+    char small[3];
+    std::to_chars_result written = to_chars(small, small + sizeof(small), from_uint(1234));
+    ASSERT_EQ(written.ec, std::errc::value_too_large);
+
+    uint2022_t value = from_uint(5);
+    const char* letters = "abc";
+    std::from_chars_result parsed = from_chars(letters, letters + 3, value);
+    ASSERT_EQ(parsed.ec, std::errc::invalid_argument);
+    ASSERT_EQ(parsed.ptr, letters);
+    ASSERT_EQ(value, from_uint(5));
+
+    // 2^2240 не помещается
+    std::string too_big = "2028571348927282222444554037802398897320966318206319106648112301460990628551464730522241303647224363"
+                          "0949071572609878635484881611123168084522644835372427545328958067027721796192883007640708111048246558"
+                          "7228976018799780290606465698196232041597111159153869078635638735543524306207918549051538549551164404"
+                          "5708190718643548202677137997420304828472712354625273953850875049852789852942940367152794233174122360"
+                          "8813443774157382835112698270753149374505992040104529532375811968006024406838006684751529938958374928"
+                          "6466143251601578398630740197236079859254441981368797290215252030523949959906421461737965638982831197"
+                          "169919730369179456856294549967631332332498659945988123043666582894622539776";
+    parsed = from_chars(too_big.data(), too_big.data() + too_big.size(), value);
+    ASSERT_EQ(parsed.ec, std::errc::result_out_of_range);
+    ASSERT_EQ(parsed.ptr, too_big.data() + too_big.size());
+    ASSERT_EQ(value, from_uint(5));
+
+    // Ведущие нули и остановка на первой не-цифре
+    const char* padded = "000000000000123 tail";
+    parsed = from_chars(padded, padded + std::strlen(padded), value);
+    ASSERT_EQ(parsed.ec, std::errc());
+    ASSERT_EQ(parsed.ptr, padded + 15);
+    ASSERT_EQ(value, from_uint(123));
+}
+
+
+// Другие ширины BigUint и вычисления во время компиляции
+using uint256_t = BigUint<256>;
+using uint4096_t = BigUint<4096>;
+
+static_assert(sizeof(uint256_t) == 32, "BigUint<256> must not pay for wider numbers");
+static_assert(sizeof(BigUint<512>) == 64, "BigUint<512> must not pay for wider numbers");
+static_assert(uint256_t::MAX_DIGITS == 78 && BigUint<512>::MAX_DIGITS == 155 && uint4096_t::MAX_DIGITS == 1234,
+              "MAX_DIGITS must match the width");
+
+// Заполняет words младших 32-битных слов псевдослучайными значениями (constexpr LCG)
+template <int Bits>
+constexpr BigUint<Bits> pattern_number(int words, uint32_t seed) {
+    BigUint<Bits> result;
+    for (int i = 0; i < words; ++i) {
+        seed = seed * 1664525 + 1013904223;
+        int bit = i * 32;
+        result.data[bit / result.LIMB_BITS] |= (typename BigUint<Bits>::limb_t)seed << (bit % result.LIMB_BITS);
+    }
+    return result;
+}
+
+constexpr uint256_t MAX_256 = uint256_t::from_string(
+    "115792089237316195423570985008687907853269984665640564039457584007913129639935");
+static_assert(MAX_256 + uint256_t::from_uint(1) == uint256_t(), "2^256 wraps to zero");
+static_assert(MAX_256 % uint256_t::from_uint(1000) == uint256_t::from_uint(935), "constexpr division by a limb");
+static_assert(MAX_256 / MAX_256 == uint256_t::from_uint(1), "constexpr Knuth division");
+
+// Карацуба (оба множителя по 2048 бит) и алгоритм D во время компиляции
+constexpr uint4096_t KARATSUBA_A = pattern_number<4096>(64, 1);
+constexpr uint4096_t KARATSUBA_B = pattern_number<4096>(64, 2);
+constexpr uint4096_t KARATSUBA_PRODUCT = KARATSUBA_A * KARATSUBA_B;
+static_assert(KARATSUBA_PRODUCT / KARATSUBA_B == KARATSUBA_A, "constexpr Karatsuba product");
+static_assert(KARATSUBA_PRODUCT % KARATSUBA_A == uint4096_t(), "constexpr Karatsuba product");
+
+TEST(BigUintTests, Width256Test) {
+    char buffer[uint256_t::MAX_DIGITS];
+    std::to_chars_result written = to_chars(buffer, buffer + sizeof(buffer), MAX_256);
+    ASSERT_EQ(written.ec, std::errc());
+    ASSERT_EQ(std::string(buffer, written.ptr),
+              "115792089237316195423570985008687907853269984665640564039457584007913129639935");
+
+    uint256_t value;
+    std::string too_big = "115792089237316195423570985008687907853269984665640564039457584007913129639936";
+    ASSERT_EQ(from_chars(too_big.data(), too_big.data() + too_big.size(), value).ec, std::errc::result_out_of_range);
+
+    uint256_t a = uint256_t::from_string("340282366920938463463374607431768211457");
+    // (2^128 + 1)^2 = 2^256 + 2^129 + 1, старший разряд отбрасывается
+    ASSERT_EQ(a * a, uint256_t::from_string("680564733841876926926749214863536422913"));
+    ASSERT_EQ(uint256_t() - uint256_t::from_uint(1), MAX_256);
+    ASSERT_EQ(significant_limbs(a), 128 / uint256_t::LIMB_BITS + 1);
+}
+
+TEST(BigUintTests, Width4096Test) {
+    for (int words = 1; words <= 128; words += 9) {
+        uint4096_t a = pattern_number<4096>(128, words);
+        uint4096_t b = pattern_number<4096>(words, words + 1);
+        BigUintDivmod<4096> parts = divmod(a, b);
+
+        // a = q * b + r, r < b
+        ASSERT_EQ(parts.quotient * b + parts.remainder, a) << words << " words";
+        ASSERT_EQ(divmod(parts.remainder, b).quotient, uint4096_t()) << words << " words";
+
+        uint4096_t half = pattern_number<4096>(64, words);
+        uint4096_t other = pattern_number<4096>(words < 64 ? words : 64, words + 2);
+        ASSERT_EQ((half * other) / other, half) << words << " words";
+        ASSERT_EQ((half * other) % half, uint4096_t()) << words << " words";
+    }
+}
+
+
+// Сдвиги по одному биту через 32-битные слова (эталон для <<= и >>=)
+uint2022_t shift_left_reference(const uint2022_t& value, int shift) {
+    uint2022_t result;
+    for (int i = 0; i + shift < WORDS * 32; ++i) {
+        int to = i + shift;
+        uint32_t bit = (get_word(value, i / 32) >> (i % 32)) & 1;
+        set_word(result, to / 32, get_word(result, to / 32) | (bit << (to % 32)));
+    }
+    return result;
+}
+
+uint2022_t shift_right_reference(const uint2022_t& value, int shift) {
+    uint2022_t result;
+    for (int to = 0; to + shift < WORDS * 32; ++to) {
+        int i = to + shift;
+        uint32_t bit = (get_word(value, i / 32) >> (i % 32)) & 1;
+        set_word(result, to / 32, get_word(result, to / 32) | (bit << (to % 32)));
+    }
+    return result;
+}
+
+class CompoundTestsSuite : public testing::TestWithParam<std::tuple<int, int>> {
+};
+
+TEST_P(CompoundTestsSuite, MatchesReferenceTest) {
+    int first_words = std::get<0>(GetParam());
+    int second_words = std::get<1>(GetParam());
+    std::mt19937 rng(first_words * 1000 + second_words + 3);
+
+    for (int iteration = 0; iteration < 10; ++iteration) {
+        uint2022_t a = random_number(rng, first_words);
+        uint2022_t b = random_number(rng, second_words);
+        uint2022_t c = random_number(rng, (int)(rng() % WORDS));
+        uint2022_t value = a;
+
+        ASSERT_EQ(value += b, full_add(a, b));
+        value = a;
+        ASSERT_EQ(value -= b, full_subtract(a, b));
+        value = a;
+        ASSERT_EQ(value *= b, schoolbook_multiply(a, b)) << first_words << " x " << second_words << " words";
+
+        uint2022_divmod_t expected = bitwise_divmod(a, b);
+        value = a;
+        ASSERT_EQ(value /= b, expected.quotient) << first_words << " / " << second_words << " words";
+        value = a;
+        ASSERT_EQ(value %= b, expected.remainder) << first_words << " % " << second_words << " words";
+
+        ASSERT_EQ(mul_add(a, b, c), full_add(schoolbook_multiply(a, b), c));
+        value = c;
+        ASSERT_EQ(add_product(value, a, b), full_add(c, schoolbook_multiply(a, b)));
+
+        int shift = (int)(rng() % (WORDS * 32 + 40));
+        value = a;
+        ASSERT_EQ(value <<= shift, shift_left_reference(a, shift)) << "<< " << shift;
+        value = a;
+        ASSERT_EQ(value >>= shift, shift_right_reference(a, shift)) << ">> " << shift;
+    }
+}
+
+TEST_P(CompoundTestsSuite, AliasingTest) {
+    std::mt19937 rng(std::get<0>(GetParam()) + 4);
+    uint2022_t a = random_number(rng, std::get<0>(GetParam()));
+    bool zero = a == uint2022_t();
+
+    uint2022_t value = a;
+    ASSERT_EQ(value += value, full_add(a, a));
+    value = a;
+    ASSERT_EQ(value -= value, uint2022_t());
+    value = a;
+    ASSERT_EQ(value *= value, schoolbook_multiply(a, a));
+    value = a;
+    ASSERT_EQ(value /= value, zero ? uint2022_t() : from_uint(1));
+    value = a;
+    ASSERT_EQ(value %= value, uint2022_t());
+    value = a;
+    ASSERT_EQ(add_product(value, value, value), full_add(a, schoolbook_multiply(a, a)));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Group,
+    CompoundTestsSuite,
+    testing::Values(
+        std::make_tuple(0, 1),
+        std::make_tuple(1, 1),
+        std::make_tuple(3, 2),
+        std::make_tuple(20, 31),
+        std::make_tuple(32, 32),
+        std::make_tuple(40, 17),
+        std::make_tuple(70, 1),
+        std::make_tuple(70, 70)
+    )
+);
+
+TEST(CompoundTests, IncrementTest) {
+    uint2022_t value = from_string("18446744073709551615");
+    uint2022_t old = value++;
+    ASSERT_EQ(old, from_string("18446744073709551615"));
+    ASSERT_EQ(value, from_string("18446744073709551616"));
+    ASSERT_EQ(++value, from_string("18446744073709551617"));
+
+    // 2^2240 - 1 + 1 оборачивается в ноль
+    uint2022_t max = uint2022_t() - from_uint(1);
+    ASSERT_EQ(++max, uint2022_t());
+
+    BigUint<256> small = BigUint<256>::from_uint(7);
+    small <<= 254; // старший из трёх битов выходит за ширину
+    small >>= 253;
+    ASSERT_EQ(small, BigUint<256>::from_uint(6));
+}
+
+// Составные операторы тоже constexpr
+constexpr uint2022_t compound_constant() {
+    uint2022_t value = from_uint(1);
+    for (int i = 0; i < 100; ++i) {
+        value *= from_uint(3);
+        ++value;
+    }
+    value <<= 7;
+    value %= from_string("1000000000000000000000000000057");
+    value >>= 1;
+    return value;
+}
+
+static_assert(compound_constant() == from_string("268454679496385956756108632"), "constexpr compound operators");
+
+
+class BitwiseTestsSuite : public testing::TestWithParam<std::tuple<int, int>> {
+};
+
+TEST_P(BitwiseTestsSuite, MatchesWordsTest) {
+    int first_words = std::get<0>(GetParam());
+    int second_words = std::get<1>(GetParam());
+    std::mt19937 rng(first_words * 1000 + second_words + 5);
+
+    for (int iteration = 0; iteration < 50; ++iteration) {
+        uint2022_t a = random_number(rng, first_words);
+        uint2022_t b = random_number(rng, second_words);
+        uint2022_t expected_and;
+        uint2022_t expected_or;
+        uint2022_t expected_xor;
+        int expected_bit_length = 0;
+        int expected_popcount = 0;
+        int expected_countr_zero = WORDS * 32;
+
+        for (int i = 0; i < WORDS; ++i) {
+            uint32_t x = get_word(a, i);
+            uint32_t y = get_word(b, i);
+            set_word(expected_and, i, x & y);
+            set_word(expected_or, i, x | y);
+            set_word(expected_xor, i, x ^ y);
+            expected_popcount += __builtin_popcount(x);
+            if (x != 0) {
+                expected_bit_length = i * 32 + 32 - __builtin_clz(x);
+                if (expected_countr_zero == WORDS * 32) {
+                    expected_countr_zero = i * 32 + __builtin_ctz(x);
+                }
+            }
+        }
+
+        ASSERT_EQ(a & b, expected_and);
+        ASSERT_EQ(a | b, expected_or);
+        ASSERT_EQ(a ^ b, expected_xor);
+        ASSERT_EQ(bit_length(a), expected_bit_length);
+        ASSERT_EQ(popcount(a), expected_popcount);
+        ASSERT_EQ(countr_zero(a), expected_countr_zero);
+
+        int shift = (int)(rng() % (WORDS * 32 + 40));
+        ASSERT_EQ(a << shift, shift_left_reference(a, shift)) << "<< " << shift;
+        ASSERT_EQ(a >> shift, shift_right_reference(a, shift)) << ">> " << shift;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Group,
+    BitwiseTestsSuite,
+    testing::Values(
+        std::make_tuple(0, 0),
+        std::make_tuple(1, 3),
+        std::make_tuple(5, 2),
+        std::make_tuple(33, 70),
+        std::make_tuple(70, 9),
+        std::make_tuple(70, 70)
+    )
+);
+
+TEST(BitwiseTests, SmallWidthTest) {
+    BigUint<256> one = BigUint<256>::from_uint(1);
+    ASSERT_EQ(bit_length(one << 255), 256);
+    ASSERT_EQ(countr_zero(one << 255), 255);
+    ASSERT_EQ(one << 256, BigUint<256>());
+    ASSERT_EQ(countr_zero(BigUint<256>()), 256);
+    ASSERT_EQ(popcount(BigUint<256>() - one), 256);
+    ASSERT_EQ((BigUint<256>() - one) >> 200, (one << 56) - one);
+}
+
+// Сдвиги и побитовые операции во время компиляции
+static_assert((from_string("340282366920938463463374607431768211457") >> 64) == from_string("18446744073709551616"),
+              "constexpr shift");
+static_assert(bit_length(from_string("340282366920938463463374607431768211456")) == 129, "constexpr bit_length");
+static_assert(((from_uint(0xF0F0) ^ from_uint(0xFF00)) & from_uint(0x0FF0)) == from_uint(0x0FF0), "constexpr bitwise");
+
+
+// Возведение в степень через % после каждого умножения (эталон для
+// Монтгомери; произведение должно помещаться, поэтому модуль до 1120 бит)
+uint2022_t powmod_reference(uint2022_t base, const uint2022_t& exponent, const uint2022_t& modulus) {
+    uint2022_t result = from_uint(1) % modulus;
+    base = base % modulus;
+    for (int i = bit_length(exponent) - 1; i >= 0; --i) {
+        result = result * result % modulus;
+        if (((get_word(exponent, i / 32) >> (i % 32)) & 1) != 0) {
+            result = result * base % modulus;
+        }
+    }
+    return result;
+}
+
+class MontgomeryTestsSuite : public testing::TestWithParam<std::tuple<int, int>> {
+};
+
+TEST_P(MontgomeryTestsSuite, MatchesReferenceTest) {
+    int modulus_words = std::get<0>(GetParam());
+    int exponent_words = std::get<1>(GetParam());
+    std::mt19937 rng(modulus_words * 1000 + exponent_words + 6);
+
+    for (int iteration = 0; iteration < 5; ++iteration) {
+        uint2022_t modulus = random_number(rng, modulus_words);
+        set_word(modulus, 0, get_word(modulus, 0) | 1);
+        set_word(modulus, modulus_words - 1, get_word(modulus, modulus_words - 1) | 0x80000000);
+        uint2022_montgomery_t context(modulus);
+        ASSERT_TRUE(context.valid());
+
+        uint2022_t a = random_number(rng, modulus_words) % modulus;
+        uint2022_t b = random_number(rng, modulus_words) % modulus;
+        uint2022_t exponent = random_number(rng, exponent_words);
+
+        ASSERT_EQ(context.from_montgomery(context.to_montgomery(a)), a);
+        ASSERT_EQ(context.from_montgomery(context.mulmod(context.to_montgomery(a), context.to_montgomery(b))),
+                  a * b % modulus) << modulus_words << " words";
+        ASSERT_EQ(context.powmod(a, exponent), powmod_reference(a, exponent, modulus))
+            << modulus_words << " words ^ " << exponent_words << " words";
+        // Основание больше модуля приводится
+        ASSERT_EQ(context.powmod(a + modulus, exponent), powmod_reference(a, exponent, modulus));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Group,
+    MontgomeryTestsSuite,
+    testing::Values(
+        std::make_tuple(1, 1),
+        std::make_tuple(2, 3),
+        std::make_tuple(3, 1),
+        std::make_tuple(8, 8),
+        std::make_tuple(17, 2),
+        std::make_tuple(35, 35)
+    )
+);
+
+TEST(MontgomeryTests, FermatTest) {
+    // Простые Мерсенна 2^p - 1: a^(m - 1) = 1 и a^m = a по модулю m,
+    // в том числе для модулей, квадрат которых не помещается в uint2022_t
+    for (int p : {127, 521, 1279, 2203}) {
+        uint2022_t modulus = (from_uint(1) << p) - from_uint(1);
+        uint2022_montgomery_t context(modulus);
+        uint2022_t a = from_string("123456789012345678901234567890");
+
+        ASSERT_EQ(context.powmod(a, modulus - from_uint(1)), from_uint(1)) << p;
+        ASSERT_EQ(context.powmod(a, modulus), a) << p;
+        ASSERT_EQ(context.powmod(a, uint2022_t()), from_uint(1)) << p;
+    }
+
+    // Модуль во всю ширину: R = 2^2240 не помещается в число
+    uint2022_t full = uint2022_t() - from_uint(1);
+    uint2022_montgomery_t context(full);
+    uint2022_t x = from_string("98765432109876543210");
+    ASSERT_EQ(context.from_montgomery(context.mulmod(context.to_montgomery(x), context.to_montgomery(x))), x * x);
+}
+
+TEST(MontgomeryTests, WidestTest) {
+    // Наибольшая ширина BigUint: R^2 mod m считается без числа двойной ширины
+    using wide_t = BigUint<32768>;
+    wide_t mersenne = (wide_t::from_uint(1) << 4423) - wide_t::from_uint(1);
+    MontgomeryContext<32768> prime(mersenne);
+    wide_t a = wide_t::from_uint(0xDEADBEEF) << 3000;
+    ASSERT_EQ(prime.powmod(a, mersenne - wide_t::from_uint(1)), wide_t::from_uint(1));
+    ASSERT_EQ(prime.from_montgomery(prime.to_montgomery(a)), a);
+
+    // Модуль во всю ширину
+    wide_t full = wide_t() - wide_t::from_uint(1);
+    MontgomeryContext<32768> context(full);
+    ASSERT_TRUE(context.valid());
+    wide_t x = wide_t::from_uint(0xFEDCBA98) << 16000;
+    ASSERT_EQ(context.from_montgomery(context.to_montgomery(x)), x);
+    ASSERT_EQ(context.from_montgomery(context.mulmod(context.to_montgomery(x), context.to_montgomery(x))), x * x);
+    ASSERT_EQ(context.powmod(x, wide_t::from_uint(2)), x * x);
+}
+
+TEST(MontgomeryTests, InvalidModulusTest) {
+    for (uint32_t m : {0u, 1u, 2u, 1000u}) {
+        uint2022_montgomery_t context(from_uint(m));
+        ASSERT_FALSE(context.valid()) << m;
+        ASSERT_EQ(context.powmod(from_uint(3), from_uint(5)), uint2022_t()) << m;
+        ASSERT_EQ(context.to_montgomery(from_uint(3)), uint2022_t()) << m;
+    }
+}
+
+// Малая теорема Ферма для p = 2^255 - 19 во время компиляции
+constexpr BigUint<256> P25519 = (BigUint<256>::from_uint(1) << 255) - BigUint<256>::from_uint(19);
+static_assert(MontgomeryContext<256>(P25519).powmod(BigUint<256>::from_uint(2), P25519 - BigUint<256>::from_uint(1))
+                  == BigUint<256>::from_uint(1),
+              "constexpr powmod");